@@ -0,0 +1,189 @@
+import std;
+import simulation_engine;
+
+namespace sim {
+
+constexpr std::size_t kDepth = 10;
+constexpr std::size_t kQuotes = 4096;
+constexpr std::size_t kOrdersPerQuote = 16;
+
+std::vector<Quote<kDepth>> makeQuotes() {
+    std::mt19937_64 rng{11};
+    std::vector<Quote<kDepth>> quotes(kQuotes);
+    for (Quote<kDepth>& quote : quotes) {
+        const std::int64_t mid = 2'000'000 + static_cast<std::int64_t>(rng() % 1000);
+        for (std::size_t level = 0; level < kDepth; ++level) {
+            const std::int64_t offset = static_cast<std::int64_t>(level + 1);
+            quote.prices[level] = Ticks{mid - offset};
+            quote.prices[kDepth + level] = Ticks{mid + offset};
+            quote.sizes[level] = Ticks{static_cast<std::int64_t>(1 + rng() % 500)};
+            quote.sizes[kDepth + level] = Ticks{static_cast<std::int64_t>(1 + rng() % 500)};
+        }
+    }
+    return quotes;
+}
+
+// Limit prices of buy orders reaching zero to all levels past the best ask
+std::vector<Ticks> makeLimits(const Quote<kDepth>& quote, std::mt19937_64& rng) {
+    std::vector<Ticks> limits(kOrdersPerQuote);
+    for (Ticks& limit : limits) {
+        limit = quote.ask(0) + Ticks{static_cast<std::int64_t>(rng() % (kDepth + 2)) - 1};
+    }
+    return limits;
+}
+
+// The previous sizing code: walk the asks until the limit stops crossing
+std::int64_t scalarSharesAvailable(const Quote<kDepth>& quote, Ticks limit, std::int64_t desired) {
+    std::int64_t available = 0;
+    for (std::size_t level = 0; level < kDepth && available < desired; ++level) {
+        if (quote.ask(level) <= limit) {
+            available += quote.askSize(level).value();
+        } else {
+            break;
+        }
+    }
+    return std::min(available, desired);
+}
+
+// The previous pricing code: walk the asks again until the fill is covered
+std::int64_t scalarAveragePrice(const Quote<kDepth>& quote, std::int64_t shares) {
+    std::int64_t notional = 0;
+    std::int64_t taken = 0;
+    for (std::size_t level = 0; level < kDepth && taken < shares; ++level) {
+        const std::int64_t atLevel = std::min(quote.askSize(level).value(), shares - taken);
+        notional += quote.ask(level).value() * atLevel;
+        taken += atLevel;
+    }
+    return (taken > 0) ? notional / taken : 0;
+}
+
+std::int64_t fillAgainst(const DepthLadder<kDepth>& ladder, Ticks limit, std::int64_t desired) {
+    const std::int64_t shares =
+        std::min(sharesAvailable(ladder, OrderInstruction::Buy, limit), desired);
+    return averageFillPrice(ladder, shares).value();
+}
+
+/**
+ * @brief Size and price every order against its quote, one order at a time.
+ * @details The ladder is built per order unless ladderPerQuote shares one ladder between all
+ * orders on the same quote. The engine also shares it, through the batched kernels.
+ */
+template <bool useKernels, bool ladderPerQuote = false>
+std::int64_t fillAll(const std::vector<Quote<kDepth>>& quotes,
+    const std::vector<std::vector<Ticks>>& limits,
+    std::int64_t desired) {
+    std::int64_t checksum = 0;
+    for (std::size_t q = 0; q < quotes.size(); ++q) {
+        if constexpr (useKernels) {
+            const DepthLadder<kDepth> quoteLadder =
+                makeDepthLadder(quotes[q], OrderInstruction::Buy);
+            for (Ticks limit : limits[q]) {
+                const std::int64_t shares = ladderPerQuote
+                    ? fillAgainst(quoteLadder, limit, desired)
+                    : fillAgainst(makeDepthLadder(quotes[q], OrderInstruction::Buy), limit, desired);
+                checksum += shares;
+            }
+        } else {
+            for (Ticks limit : limits[q]) {
+                const std::int64_t shares = scalarSharesAvailable(quotes[q], limit, desired);
+                checksum += scalarAveragePrice(quotes[q], shares);
+            }
+        }
+    }
+    return checksum;
+}
+
+// Best of several repetitions, the machine is rarely quiet enough for a single run
+template <typename Function>
+void measure(const std::string& name,
+    std::size_t numberOfOrders,
+    std::size_t repetitions,
+    Function&& function) {
+    double best = std::numeric_limits<double>::max();
+    std::int64_t checksum = 0;
+    for (std::size_t repetition = 0; repetition < repetitions; ++repetition) {
+        const auto start = std::chrono::steady_clock::now();
+        checksum = function();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    std::cout << std::left << std::setw(34) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(2) << best * 1e3 << " ms" << std::setw(10)
+              << best * 1e9 / static_cast<double>(numberOfOrders) << " ns/order"
+              << "  (checksum " << checksum << ")" << std::endl;
+}
+
+}  // namespace sim
+
+int main(int argc, char** argv) {
+    using namespace sim;
+
+    // Usage: depth_kernel_benchmark [repetitions]
+    const std::size_t repetitions = (argc > 1) ? std::stoull(argv[1]) : 15;
+    const std::size_t numberOfOrders = kQuotes * kOrdersPerQuote;
+    constexpr std::int64_t kDesired = 1'500;
+
+    const std::vector<Quote<kDepth>> quotes = makeQuotes();
+    std::mt19937_64 rng{13};
+    std::vector<std::vector<Ticks>> limits;
+    limits.reserve(kQuotes);
+    for (const Quote<kDepth>& quote : quotes) limits.push_back(makeLimits(quote, rng));
+
+    // Fill sizes for the pricing-only runs, up to twice the visible size
+    std::vector<std::int64_t> shares(numberOfOrders);
+    for (std::int64_t& s : shares) s = static_cast<std::int64_t>(rng() % (2 * 500 * kDepth));
+
+    std::cout << "Depth: " << kDepth << ", quotes: " << kQuotes
+              << ", orders per quote: " << kOrdersPerQuote << ", repetitions: " << repetitions
+              << "\n"
+              << std::endl;
+
+    measure("sizing, scalar walk", numberOfOrders, repetitions, [&] {
+        std::int64_t checksum = 0;
+        for (std::size_t q = 0; q < kQuotes; ++q) {
+            for (Ticks limit : limits[q]) {
+                checksum += scalarSharesAvailable(quotes[q], limit, kDesired);
+            }
+        }
+        return checksum;
+    });
+    measure("sizing, batched sharesAvailable", numberOfOrders, repetitions, [&] {
+        std::int64_t checksum = 0;
+        std::array<std::int64_t, kOrdersPerQuote> available{};
+        for (std::size_t q = 0; q < kQuotes; ++q) {
+            const DepthLadder<kDepth> ladder = makeDepthLadder(quotes[q], OrderInstruction::Buy);
+            sharesAvailable(ladder, OrderInstruction::Buy, std::span<const Ticks>{limits[q]},
+                std::span<std::int64_t>{available});
+            for (std::int64_t a : available) checksum += std::min(a, kDesired);
+        }
+        return checksum;
+    });
+    measure("pricing, scalar walk", numberOfOrders, repetitions, [&] {
+        std::int64_t checksum = 0;
+        for (std::size_t i = 0; i < numberOfOrders; ++i) {
+            checksum += scalarAveragePrice(quotes[i / kOrdersPerQuote], shares[i]);
+        }
+        return checksum;
+    });
+    measure("pricing, batched averageFillPrice", numberOfOrders, repetitions, [&] {
+        std::int64_t checksum = 0;
+        std::array<Ticks, kOrdersPerQuote> prices{};
+        for (std::size_t q = 0; q < kQuotes; ++q) {
+            const DepthLadder<kDepth> ladder = makeDepthLadder(quotes[q], OrderInstruction::Buy);
+            averageFillPrice(ladder,
+                std::span<const std::int64_t>{shares.data() + q * kOrdersPerQuote, kOrdersPerQuote},
+                std::span<Ticks>{prices});
+            for (Ticks price : prices) checksum += price.value();
+        }
+        return checksum;
+    });
+    measure("fill, scalar walks", numberOfOrders, repetitions,
+        [&] { return fillAll<false>(quotes, limits, kDesired); });
+    measure("fill, kernels, ladder per order", numberOfOrders, repetitions,
+        [&] { return fillAll<true>(quotes, limits, kDesired); });
+    measure("fill, kernels, ladder per quote", numberOfOrders, repetitions,
+        [&] { return fillAll<true, true>(quotes, limits, kDesired); });
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+import std;
+import simulation_engine;
+
+namespace sim {
+
+using Distribution = BetaDistribution;
+
+/**
+ * @brief Synthetic quotes of one symbol: a mid price random walk with a full ten-level book,
+ * starting at 14:00 UTC so every quote falls within regular trading hours.
+ */
+std::vector<Quote<10>> makeQuotes(std::size_t numberOfQuotes) {
+    std::mt19937_64 rng{11};
+    std::vector<Quote<10>> quotes(numberOfQuotes);
+    std::uint64_t timestamp = 1'761'314'400'000'000'000ULL;
+    std::int64_t mid = 2'000'000;
+    for (Quote<10>& quote : quotes) {
+        timestamp += 1'000'000 + rng() % 1'000'000;
+        mid += static_cast<std::int64_t>(rng() % 3) - 1;
+        quote.symbolId = 0;
+        quote.timestamp = TimeStamp{timestamp};
+        for (std::size_t level = 0; level < 10; ++level) {
+            const auto offset = static_cast<std::int64_t>(level);
+            quote.prices[2 * level] = Ticks{mid - 1 - offset};
+            quote.prices[2 * level + 1] = Ticks{mid + 1 + offset};
+            quote.sizes[2 * level] = Ticks{static_cast<std::int64_t>(1 + rng() % 500)};
+            quote.sizes[2 * level + 1] = Ticks{static_cast<std::int64_t>(1 + rng() % 500)};
+        }
+    }
+    return quotes;
+}
+
+/**
+ * @brief Keeps a one-share bid and offer working kOffset ticks outside the touch, replacing each
+ * once it fills. There is always an order to match, so every quote runs the matching phase.
+ */
+class QuotingStrategy final : public StrategyBase<10, 1, Distribution> {
+   public:
+    explicit QuotingStrategy(const RunParams<Distribution>& params)
+        : StrategyBase<10, 1, Distribution>(Portfolio<1, Distribution>{params}) {}
+
+    void onSymbolUpdate(const MarketState<10, 1>& marketState, std::uint16_t) {
+        if (bidId_ == OrderId{0}) {
+            bidId_ = this->placeOrder(0, OrderInstruction::Buy, OrderType::Limit, Quantity{1},
+                TimeInForce::Day, marketState.bestBid(0) - kOffset);
+        }
+        if (askId_ == OrderId{0}) {
+            askId_ = this->placeOrder(0, OrderInstruction::Sell, OrderType::Limit, Quantity{1},
+                TimeInForce::Day, marketState.bestAsk(0) + kOffset);
+        }
+    }
+
+    void onFill(const Fill& fill) {
+        StrategyBase<10, 1, Distribution>::onFill(fill);
+        if (fill.id == bidId_) bidId_ = OrderId{0};
+        if (fill.id == askId_) askId_ = OrderId{0};
+    }
+
+    void onEnd() {}
+
+   private:
+    static constexpr Ticks kOffset{20};
+
+    OrderId bidId_{0};
+    OrderId askId_{0};
+};
+
+static_assert(TradingStrategy<QuotingStrategy, 10, 1, Distribution>);
+
+RunParams<Distribution> makeRunParams(bool enforceTradingHours) {
+    RunParams<Distribution> params;
+    params.startingCash = Ticks{1'000'000'000'000};
+    params.buyFillRateDistribution = BetaDistribution{2.0, 2.0};
+    params.sellFillRateDistribution = BetaDistribution{2.0, 2.0};
+    params.sendLatencyNanoseconds = 500'000;
+    params.receiveLatencyNanoseconds = 500'000;
+    params.leverageFactor = 1;
+    params.interestRate = 5;
+    params.enforceTradingHours = enforceTradingHours;
+    params.allowExtendedHoursTrading = false;
+    params.daylightSavings = true;
+    params.verbosityLevel = VerbosityLevel::MINIMAL;
+    params.fillRateSeed = 1;
+    return params;
+}
+
+// Best of several repetitions, the machine is rarely quiet enough for a single run
+template <typename Function>
+void measure(const std::string& name,
+    std::size_t numberOfQuotes,
+    std::size_t repetitions,
+    Function&& function) {
+    double best = std::numeric_limits<double>::max();
+    std::size_t numberOfFills = 0;
+    for (std::size_t repetition = 0; repetition < repetitions; ++repetition) {
+        const auto start = std::chrono::steady_clock::now();
+        numberOfFills = function();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(2) << best * 1e3 << " ms" << std::setw(10)
+              << best * 1e9 / static_cast<double>(numberOfQuotes) << " ns/quote"
+              << "  (" << numberOfFills << " fills)" << std::endl;
+}
+
+}  // namespace sim
+
+int main(int argc, char** argv) {
+    using namespace sim;
+
+    // Usage: engine_policy_benchmark [number of quotes] [repetitions]
+    const std::size_t numberOfQuotes = (argc > 1) ? std::stoull(argv[1]) : 2'000'000;
+    const std::size_t repetitions = (argc > 2) ? std::stoull(argv[2]) : 5;
+
+    const auto store = std::make_shared<const SharedQuoteStore<10>>(makeQuotes(numberOfQuotes));
+
+    std::cout << "Quotes: " << numberOfQuotes << ", repetitions: " << repetitions << "\n"
+              << std::endl;
+
+    const auto runWith = [&]<typename Policies>(const RunParams<Distribution>& params) {
+        QuotingStrategy strategy(params);
+        Engine<10, 1, Distribution> engine(std::make_unique<MarketDataShared<10, 1>>(store),
+            params);
+        std::ostringstream report;
+        return engine.template run<Policies>(strategy, report).fills.size();
+    };
+
+    const RunParams<Distribution> tradingHours = makeRunParams(true);
+    const RunParams<Distribution> aroundTheClock = makeRunParams(false);
+
+    measure("FullRealism, trading hours", numberOfQuotes, repetitions,
+        [&] { return runWith.template operator()<FullRealism>(tradingHours); });
+    measure("FullRealism, around the clock", numberOfQuotes, repetitions,
+        [&] { return runWith.template operator()<FullRealism>(aroundTheClock); });
+    measure("RawThroughput", numberOfQuotes, repetitions,
+        [&] { return runWith.template operator()<RawThroughput>(tradingHours); });
+
+    return 0;
+}
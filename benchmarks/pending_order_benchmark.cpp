@@ -0,0 +1,102 @@
+import std;
+import simulation_engine;
+
+namespace sim {
+
+constexpr std::size_t kRestingOrders = 10'000;
+
+PendingOrder makePendingOrder(std::uint64_t id) {
+    PendingOrder pendingOrder;
+    pendingOrder.order.id = OrderId{id};
+    pendingOrder.order.quantity = Quantity{100};
+    pendingOrder.order.price = Ticks{static_cast<std::int64_t>(2'000'000 - id % 1000)};
+    return pendingOrder;
+}
+
+// The previous representation: a vector searched with find_if and erased from the middle
+struct VectorOrders {
+    std::vector<PendingOrder> orders;
+
+    void insert(const PendingOrder& pendingOrder) { orders.push_back(pendingOrder); }
+
+    PendingOrder* find(OrderId orderId) {
+        auto it = std::find_if(orders.begin(), orders.end(),
+            [orderId](const PendingOrder& po) { return po.order.id == orderId; });
+        return (it != orders.end()) ? &*it : nullptr;
+    }
+
+    bool erase(OrderId orderId) {
+        auto it = std::find_if(orders.begin(), orders.end(),
+            [orderId](const PendingOrder& po) { return po.order.id == orderId; });
+        if (it == orders.end()) return false;
+        orders.erase(it);
+        return true;
+    }
+};
+
+/**
+ * @brief A market maker's order flow against a book of resting orders.
+ * @details Every step cancels a random resting order, places a new one in its place and
+ * replaces another random resting order, so the number of resting orders stays constant.
+ */
+template <typename Orders>
+std::int64_t cancelReplaceCycle(Orders& orders, std::size_t numberOfSteps) {
+    std::mt19937_64 rng{7};
+    std::vector<std::uint64_t> restingIds(kRestingOrders);
+    for (std::uint64_t id = 1; id <= kRestingOrders; ++id) {
+        orders.insert(makePendingOrder(id));
+        restingIds[id - 1] = id;
+    }
+
+    std::uint64_t nextId = kRestingOrders + 1;
+    std::int64_t checksum = 0;
+    for (std::size_t step = 0; step < numberOfSteps; ++step) {
+        const std::size_t cancelled = rng() % kRestingOrders;
+        checksum += orders.erase(OrderId{restingIds[cancelled]}) ? 1 : 0;
+
+        restingIds[cancelled] = nextId;
+        orders.insert(makePendingOrder(nextId++));
+
+        if (PendingOrder* replaced = orders.find(OrderId{restingIds[rng() % kRestingOrders]})) {
+            replaced->order.price += Ticks{1};
+            checksum += replaced->order.price.value();
+        }
+    }
+    return checksum;
+}
+
+template <typename Function>
+void measure(const std::string& name, std::size_t numberOfSteps, Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::int64_t checksum = function();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << std::left << std::setw(34) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(2) << elapsed.count() * 1e3 << " ms" << std::setw(10)
+              << elapsed.count() * 1e9 / static_cast<double>(numberOfSteps) << " ns/step"
+              << "  (checksum " << checksum << ")" << std::endl;
+}
+
+}  // namespace sim
+
+int main(int argc, char** argv) {
+    using namespace sim;
+
+    // Usage: pending_order_benchmark [number of cancel/place/replace steps]
+    const std::size_t numberOfSteps = (argc > 1) ? std::stoull(argv[1]) : 200'000;
+
+    std::cout << "Resting orders: " << kRestingOrders << ", steps: " << numberOfSteps << "\n"
+              << std::endl;
+
+    measure("vector + find_if", numberOfSteps, [&] {
+        VectorOrders orders;
+        return cancelReplaceCycle(orders, numberOfSteps);
+    });
+    measure("PendingOrderStore", numberOfSteps, [&] {
+        PendingOrderStore orders;
+        orders.reserve(kRestingOrders);
+        return cancelReplaceCycle(orders, numberOfSteps);
+    });
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+import std;
+import simulation_engine;
+
+namespace sim {
+
+constexpr std::size_t kDepth = 10;
+constexpr std::uint16_t kSymbols = 4;
+
+// Synthetic MBP-10 stream: a random walk per symbol with a 1-3 tick spread and 100 tick levels
+std::vector<Quote<kDepth>> generateTradingDay(std::size_t numberOfQuotes) {
+    std::mt19937_64 rng{42};
+    std::uniform_int_distribution<std::int64_t> step{-100, 100};
+    std::uniform_int_distribution<std::int64_t> spread{1, 3};
+    std::uniform_int_distribution<std::int64_t> size{1, 500};
+    std::uniform_int_distribution<std::uint64_t> gap{1, 50'000};
+
+    std::array<std::int64_t, kSymbols> mid{};
+    mid.fill(2'000'000);  // $200.00 at 1e4 scale
+    TimeStamp timestamp{1'752'499'800'000'000'000ULL};  // 2025-07-14 13:30 UTC
+
+    std::vector<Quote<kDepth>> quotes(numberOfQuotes);
+    for (std::size_t i = 0; i < numberOfQuotes; ++i) {
+        const std::size_t symbol = i % kSymbols;
+        mid[symbol] += step(rng);
+        timestamp += TimeStamp{gap(rng)};
+
+        Quote<kDepth>& quote = quotes[i];
+        quote.timestamp = timestamp;
+        quote.symbolId = symbol;
+        const std::int64_t halfSpread = spread(rng) * 100;
+        for (std::size_t level = 0; level < kDepth; ++level) {
+            const std::int64_t offset = halfSpread + static_cast<std::int64_t>(level) * 100;
+            quote.prices[level] = Ticks{mid[symbol] - offset};
+            quote.prices[kDepth + level] = Ticks{mid[symbol] + offset};
+            quote.sizes[level] = Ticks{size(rng)};
+            quote.sizes[kDepth + level] = Ticks{size(rng)};
+        }
+    }
+    return quotes;
+}
+
+template <typename Function>
+void measure(const std::string& name, std::size_t numberOfQuotes, Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::int64_t checksum = function();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << std::left << std::setw(34) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(2) << elapsed.count() * 1e3 << " ms" << std::setw(10)
+              << elapsed.count() * 1e9 / static_cast<double>(numberOfQuotes) << " ns/quote"
+              << "  (checksum " << checksum << ")" << std::endl;
+}
+
+// Sum of mid prices of symbol 0: touches timestamp, symbol and level one only
+std::int64_t topOfBookScan(std::span<const Quote<kDepth>> rows) {
+    std::int64_t total = 0;
+    for (const Quote<kDepth>& quote : rows) {
+        if (quote.symbolId == 0) {
+            total += (quote.prices[0].value() + quote.prices[kDepth].value()) / 2;
+        }
+    }
+    return total;
+}
+
+std::int64_t topOfBookScan(const ColumnarQuotes<kDepth>& columns) {
+    std::int64_t total = 0;
+    const std::size_t numberOfQuotes = columns.size();
+    for (std::size_t i = 0; i < numberOfQuotes; ++i) {
+        if (columns.symbolIds[i] == 0) {
+            total += (columns.bidPrices[0][i].value() + columns.askPrices[0][i].value()) / 2;
+        }
+    }
+    return total;
+}
+
+// Size imbalance over the top three levels of every quote
+std::int64_t topThreeImbalanceScan(std::span<const Quote<kDepth>> rows) {
+    std::int64_t total = 0;
+    for (const Quote<kDepth>& quote : rows) {
+        for (std::size_t level = 0; level < 3; ++level) {
+            total += quote.sizes[level].value() - quote.sizes[kDepth + level].value();
+        }
+    }
+    return total;
+}
+
+std::int64_t topThreeImbalanceScan(const ColumnarQuotes<kDepth>& columns) {
+    std::int64_t total = 0;
+    const std::size_t numberOfQuotes = columns.size();
+    for (std::size_t level = 0; level < 3; ++level) {
+        for (std::size_t i = 0; i < numberOfQuotes; ++i) {
+            total += columns.bidSizes[level][i].value() - columns.askSizes[level][i].value();
+        }
+    }
+    return total;
+}
+
+// Full replay through IMarketData, which gathers every quote into the market state
+std::int64_t replay(std::vector<Quote<kDepth>> quotes, QuoteLayout layout) {
+    MarketDataParams params;
+    params.layout = layout;
+    MarketDataInMemory<kDepth, kSymbols> marketData(std::move(quotes), params);
+
+    std::int64_t total = 0;
+    while (marketData.nextMarketState()) {
+        total += marketData.currentMarketState().bestBid(0).value();
+    }
+    return total;
+}
+
+}  // namespace sim
+
+int main(int argc, char** argv) {
+    using namespace sim;
+
+    // Usage: quote_layout_benchmark [parquet file | number of synthetic quotes]
+    std::vector<Quote<kDepth>> rows;
+    if (argc > 1 && std::filesystem::exists(argv[1])) {
+        if (!readParquetQuotes<kDepth>(argv[1], MarketDataParams{}, rows)) {
+            std::cerr << "Could not read " << argv[1] << std::endl;
+            return 1;
+        }
+    } else {
+        const std::size_t numberOfQuotes = (argc > 1) ? std::stoull(argv[1]) : 5'000'000;
+        rows = generateTradingDay(numberOfQuotes);
+    }
+
+    ColumnarQuotes<kDepth> columns;
+    columns.assign(rows);
+    CompactQuotes<kDepth> compact;
+    compact.assign(rows);
+
+    const std::size_t numberOfQuotes = rows.size();
+    std::cout << "Quotes: " << numberOfQuotes << ", rows "
+              << numberOfQuotes * sizeof(Quote<kDepth>) / (1024 * 1024) << " MiB, columns "
+              << columns.memoryUsage() / (1024 * 1024) << " MiB, compact "
+              << compact.memoryUsage() / (1024 * 1024) << " MiB\n"
+              << std::endl;
+
+    measure("top of book scan (rows)", numberOfQuotes, [&] { return topOfBookScan(rows); });
+    measure("top of book scan (columns)", numberOfQuotes, [&] { return topOfBookScan(columns); });
+    measure("top 3 imbalance scan (rows)", numberOfQuotes,
+        [&] { return topThreeImbalanceScan(rows); });
+    measure("top 3 imbalance scan (columns)", numberOfQuotes,
+        [&] { return topThreeImbalanceScan(columns); });
+    measure("market state replay (rows)", numberOfQuotes,
+        [&] { return replay(rows, QuoteLayout::Rows); });
+    measure("market state replay (columns)", numberOfQuotes,
+        [&] { return replay(rows, QuoteLayout::Columns); });
+    measure("market state replay (compact)", numberOfQuotes,
+        [&] { return replay(rows, QuoteLayout::Compact); });
+
+    return 0;
+}
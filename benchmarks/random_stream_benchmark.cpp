@@ -0,0 +1,83 @@
+import std;
+import simulation_engine;
+
+namespace sim {
+
+constexpr std::size_t kDraws = 1 << 20;
+
+// Best of several repetitions, the machine is rarely quiet enough for a single run
+template <typename Function>
+void measure(const std::string& name, std::size_t repetitions, Function&& function) {
+    double best = std::numeric_limits<double>::max();
+    double checksum = 0.0;
+    for (std::size_t repetition = 0; repetition < repetitions; ++repetition) {
+        const auto start = std::chrono::steady_clock::now();
+        checksum = function();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(2) << best * 1e3 << " ms" << std::setw(10)
+              << best * 1e9 / static_cast<double>(kDraws) << " ns/draw"
+              << "  (checksum " << std::setprecision(4) << checksum << ")" << std::endl;
+}
+
+}  // namespace sim
+
+int main(int argc, char** argv) {
+    using namespace sim;
+
+    // Usage: random_stream_benchmark [repetitions]
+    const std::size_t repetitions = (argc > 1) ? std::stoull(argv[1]) : 10;
+    const PhiloxKey key = deriveStreamKey(20251024, 0, 0);
+
+    std::cout << "Draws: " << kDraws << ", repetitions: " << repetitions
+              << ", sizeof(std::mt19937): " << sizeof(std::mt19937)
+              << ", sizeof(RandomStream): " << sizeof(RandomStream) << "\n"
+              << std::endl;
+
+    // One long sequence, the way the engine drew before
+    measure("mt19937, one generator", repetitions, [] {
+        std::mt19937 generator{1};
+        std::uniform_real_distribution<double> uniform{0.0, 1.0};
+        double sum = 0.0;
+        for (std::size_t i = 0; i < kDraws; ++i) sum += uniform(generator);
+        return sum;
+    });
+    measure("RandomStream, one stream", repetitions, [&] {
+        RandomStream stream(key, 0);
+        std::uniform_real_distribution<double> uniform{0.0, 1.0};
+        double sum = 0.0;
+        for (std::size_t i = 0; i < kDraws; ++i) sum += uniform(stream);
+        return sum;
+    });
+    measure("RandomStream, fillUniform", repetitions, [&] {
+        RandomStream stream(key, 0);
+        std::vector<double> draws(kDraws);
+        stream.fillUniform(draws);
+        return std::accumulate(draws.begin(), draws.end(), 0.0);
+    });
+
+    // A generator per draw site, which is what reproducibility under any scheduling needs
+    measure("mt19937, seeded per order", repetitions / 5 + 1, [] {
+        std::uniform_real_distribution<double> uniform{0.0, 1.0};
+        double sum = 0.0;
+        for (std::size_t order = 0; order < kDraws; ++order) {
+            std::mt19937 generator{static_cast<std::uint32_t>(order)};
+            sum += uniform(generator);
+        }
+        return sum;
+    });
+    measure("RandomStream, stream per order", repetitions, [&] {
+        std::uniform_real_distribution<double> uniform{0.0, 1.0};
+        double sum = 0.0;
+        for (std::size_t order = 0; order < kDraws; ++order) {
+            RandomStream stream(key, order);
+            sum += uniform(stream);
+        }
+        return sum;
+    });
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+import std;
+import simulation_engine;
+
+namespace sim {
+
+using Distribution = ConstantDistribution;
+
+/**
+ * @brief Synthetic quotes of one symbol: a mid price random walk with a full ten-level book.
+ */
+std::vector<Quote<10>> makeQuotes(std::size_t numberOfQuotes) {
+    std::mt19937_64 rng{11};
+    std::vector<Quote<10>> quotes(numberOfQuotes);
+    std::uint64_t timestamp = 1'761'300'000'000'000'000ULL;
+    std::int64_t mid = 2'000'000;
+    for (Quote<10>& quote : quotes) {
+        timestamp += 1'000'000 + rng() % 1'000'000;
+        mid += static_cast<std::int64_t>(rng() % 3) - 1;
+        quote.symbolId = 0;
+        quote.timestamp = TimeStamp{timestamp};
+        for (std::size_t level = 0; level < 10; ++level) {
+            const auto offset = static_cast<std::int64_t>(level);
+            quote.prices[2 * level] = Ticks{mid - 1 - offset};
+            quote.prices[2 * level + 1] = Ticks{mid + 1 + offset};
+            quote.sizes[2 * level] = Ticks{static_cast<std::int64_t>(1 + rng() % 500)};
+            quote.sizes[2 * level + 1] = Ticks{static_cast<std::int64_t>(1 + rng() % 500)};
+        }
+    }
+    return quotes;
+}
+
+/**
+ * @brief The per-quote work of a light strategy: an exponential average of the mid price, and a
+ * one-share order whenever the mid crosses it by more than a threshold.
+ */
+struct MeanReversionSignal {
+    double average{0.0};
+    std::uint64_t crossings{0};
+
+    // The instruction to trade, if any
+    std::optional<OrderInstruction> update(const MarketState<10, 1>& marketState) {
+        const double mid = 0.5 * static_cast<double>(marketState.bestBid(0).value() +
+                                                     marketState.bestAsk(0).value());
+        if (average == 0.0) average = mid;
+        average += 0.01 * (mid - average);
+
+        if (mid > average + 20.0) {
+            ++crossings;
+            return OrderInstruction::Sell;
+        }
+        if (mid < average - 20.0) {
+            ++crossings;
+            return OrderInstruction::Buy;
+        }
+        return std::nullopt;
+    }
+};
+
+// The signal behind the virtual IStrategy interface
+class VirtualStrategy final : public IStrategy<10, 1, Distribution> {
+   public:
+    explicit VirtualStrategy(const RunParams<Distribution>& params)
+        : IStrategy<10, 1, Distribution>(Portfolio<1, Distribution>{params}) {}
+
+    void onSymbolUpdate(const MarketState<10, 1>& marketState, std::uint16_t) override {
+        if (const auto instruction = signal.update(marketState)) {
+            this->placeOrder(0, *instruction, OrderType::Market, Quantity{1});
+        }
+    }
+
+    MeanReversionSignal signal;
+};
+
+// The same signal bound at compile time, with no virtual functions at all
+class BoundStrategy final : public StrategyBase<10, 1, Distribution> {
+   public:
+    explicit BoundStrategy(const RunParams<Distribution>& params)
+        : StrategyBase<10, 1, Distribution>(Portfolio<1, Distribution>{params}) {}
+
+    void onSymbolUpdate(const MarketState<10, 1>& marketState, std::uint16_t) {
+        if (const auto instruction = signal.update(marketState)) {
+            this->placeOrder(0, *instruction, OrderType::Market, Quantity{1});
+        }
+    }
+
+    void onEnd() {}
+
+    MeanReversionSignal signal;
+};
+
+static_assert(TradingStrategy<BoundStrategy, 10, 1, Distribution>);
+
+RunParams<Distribution> makeRunParams() {
+    RunParams<Distribution> params;
+    params.startingCash = Ticks{1'000'000'000'000};
+    params.buyFillRateDistribution = ConstantDistribution{100.0};
+    params.sellFillRateDistribution = ConstantDistribution{100.0};
+    params.sendLatencyNanoseconds = 500'000;
+    params.receiveLatencyNanoseconds = 500'000;
+    params.leverageFactor = 1;
+    params.enforceTradingHours = false;
+    params.verbosityLevel = VerbosityLevel::MINIMAL;
+    params.fillRateSeed = 1;
+    return params;
+}
+
+// Best of several repetitions, the machine is rarely quiet enough for a single run
+template <typename Function>
+void measure(const std::string& name,
+    std::size_t numberOfQuotes,
+    std::size_t repetitions,
+    Function&& function) {
+    double best = std::numeric_limits<double>::max();
+    std::uint64_t checksum = 0;
+    for (std::size_t repetition = 0; repetition < repetitions; ++repetition) {
+        const auto start = std::chrono::steady_clock::now();
+        checksum = function();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed
+              << std::setprecision(2) << best * 1e3 << " ms" << std::setw(10)
+              << best * 1e9 / static_cast<double>(numberOfQuotes) << " ns/quote"
+              << "  (checksum " << checksum << ")" << std::endl;
+}
+
+}  // namespace sim
+
+int main(int argc, char** argv) {
+    using namespace sim;
+
+    // Usage: strategy_dispatch_benchmark [number of quotes] [repetitions]
+    const std::size_t numberOfQuotes = (argc > 1) ? std::stoull(argv[1]) : 2'000'000;
+    const std::size_t repetitions = (argc > 2) ? std::stoull(argv[2]) : 5;
+
+    const auto store = std::make_shared<const SharedQuoteStore<10>>(makeQuotes(numberOfQuotes));
+    const RunParams<Distribution> params = makeRunParams();
+
+    std::cout << "Quotes: " << numberOfQuotes << ", repetitions: " << repetitions << "\n"
+              << std::endl;
+
+    const auto runWith = [&]<typename Strategy>(Strategy& strategy) {
+        Engine<10, 1, Distribution> engine(std::make_unique<MarketDataShared<10, 1>>(store),
+            params);
+        std::ostringstream report;
+        const auto result = engine.run(strategy, report);
+        return result.fills.size() * 1'000'003 + strategy.signal.crossings;
+    };
+
+    measure("IStrategy&, virtual dispatch", numberOfQuotes, repetitions, [&] {
+        VirtualStrategy strategy(params);
+        IStrategy<10, 1, Distribution>& base = strategy;
+        Engine<10, 1, Distribution> engine(std::make_unique<MarketDataShared<10, 1>>(store),
+            params);
+        std::ostringstream report;
+        const auto result = engine.run(base, report);
+        return result.fills.size() * 1'000'003 + strategy.signal.crossings;
+    });
+    measure("IStrategy subclass, bound by type", numberOfQuotes, repetitions, [&] {
+        VirtualStrategy strategy(params);
+        return runWith(strategy);
+    });
+    measure("TradingStrategy, no virtual functions", numberOfQuotes, repetitions, [&] {
+        BoundStrategy strategy(params);
+        return runWith(strategy);
+    });
+
+    return 0;
+}
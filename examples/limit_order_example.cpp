@@ -53,7 +53,7 @@ int main() {
 
     auto params = sim::setRunParams();
 
-    auto dataManager = std::make_unique<sim::MarketDataParquet<10, 4>>(filePaths);
+    auto dataManager = std::make_unique<sim::MarketDataParquet<10, 4>>(filePaths, params.marketData);
 
     sim::LimitOrderExampleStrategy strat{params};
 
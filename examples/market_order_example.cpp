@@ -52,7 +52,7 @@ int main() {
 
     auto params = sim::setRunParams();
 
-    auto dataManager = std::make_unique<sim::MarketDataParquet<10, 1>>(filePaths);
+    auto dataManager = std::make_unique<sim::MarketDataParquet<10, 1>>(filePaths, params.marketData);
 
     sim::MarketOrderExampleStrategy strat{params};
 
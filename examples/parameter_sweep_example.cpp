@@ -0,0 +1,151 @@
+import std;
+import simulation_engine;
+
+namespace sim {
+
+// One point of the sweep: how far below the best ask to bid, and the round-trip latency
+struct SweepParameters {
+    Ticks limitOffset;
+    std::uint64_t latencyNanoseconds;
+
+    bool operator==(const SweepParameters&) const = default;
+};
+
+class PassiveBidStrategy : public IStrategy<10, 1, ConstantDistribution> {
+   public:
+    PassiveBidStrategy(const RunParams<ConstantDistribution>& params, Ticks limitOffset)
+        : IStrategy<10, 1, ConstantDistribution>(Portfolio<1, ConstantDistribution>{params}),
+          limitOffset_{limitOffset} {}
+
+    void onMarketData(const MarketState<10, 1>& marketState) override {
+        if (!orderPlaced_) {
+            this->placeOrder(0, OrderInstruction::Buy, OrderType::Limit, Quantity{1},
+                TimeInForce::Day, marketState.bestAsk(0) - limitOffset_);
+            orderPlaced_ = true;
+        }
+    }
+
+    // Branches restored from a snapshot must know whether the order was already placed
+    void saveState(SnapshotWriter& out) const override {
+        IStrategy<10, 1, ConstantDistribution>::saveState(out);
+        out.write(orderPlaced_);
+    }
+
+    bool loadState(SnapshotReader& in) override {
+        return IStrategy<10, 1, ConstantDistribution>::loadState(in) && in.read(orderPlaced_);
+    }
+
+   private:
+    Ticks limitOffset_;
+    bool orderPlaced_{false};
+};
+
+RunParams<ConstantDistribution> setRunParams(const SweepParameters& parameters) {
+    RunParams<ConstantDistribution> params;
+    params.depth = Depth{10};
+    params.startingCash = Ticks{1'000'000'000};
+    params.buyFillRateDistribution = ConstantDistribution{100.0};
+    params.sellFillRateDistribution = ConstantDistribution{100.0};
+    params.sendLatencyNanoseconds = parameters.latencyNanoseconds / 2;
+    params.receiveLatencyNanoseconds = parameters.latencyNanoseconds / 2;
+    params.leverageFactor = 1;
+    params.interestRate = Percentage{5};
+    params.strategyName = "PassiveBidSweep";
+    params.enforceTradingHours = true;
+    params.allowExtendedHoursTrading = true;
+    params.daylightSavings = true;
+    params.verbosityLevel = VerbosityLevel::MINIMAL;
+    params.statisticsUpdateRateSeconds = 60;
+    return params;
+}
+
+}  // namespace sim
+
+int main() {
+    using namespace sim;
+
+    std::vector<std::string> filePaths = {
+        "/mnt/klmncap3/tmp_simulation_data_indexed/ubigint_AAPL_2025-10-24.parquet",
+        "/mnt/klmncap3/tmp_simulation_data_indexed/ubigint_AAPL_2025-10-27.parquet"};
+
+    // Decode the dataset once; every run below replays the same copy
+    std::shared_ptr<const SharedQuoteStore<10>> store;
+    if (!loadSharedQuoteStore<10>(filePaths, MarketDataParams{}, store)) {
+        std::cerr << "Failed to load market data" << std::endl;
+        return 1;
+    }
+
+    std::vector<SweepParameters> grid;
+    for (std::int64_t offset : {0, 100, 500, 1'000, 5'000}) {
+        for (std::uint64_t latency : {1'000'000ULL, 10'000'000ULL, 60'000'000ULL}) {
+            grid.push_back({Ticks{offset}, latency});
+        }
+    }
+
+    ParameterSweep<10, 1, ConstantDistribution> sweep(store);
+    auto table = sweep.run(
+        grid, [](const SweepParameters& parameters) { return setRunParams(parameters); },
+        [](const SweepParameters& parameters, const RunParams<ConstantDistribution>& params) {
+            return std::make_unique<PassiveBidStrategy>(params, parameters.limitOffset);
+        });
+
+    std::cout << "Quotes: " << store->size() << ", runs: " << table.rows.size()
+              << ", threads: " << sweep.numberOfThreads() << ", wall time: "
+              << std::chrono::duration<double>(table.wallTime).count() << " s\n\n";
+    std::cout << std::left << std::setw(12) << "Offset" << std::setw(16) << "Latency (ns)"
+              << std::setw(10) << "Fills" << std::setw(20) << "Final value" << "Run time (s)"
+              << std::endl;
+    for (const auto& row : table.rows) {
+        std::cout << std::left << std::setw(12) << row.parameters.limitOffset.value()
+                  << std::setw(16) << row.parameters.latencyNanoseconds;
+        if (row.result) {
+            std::cout << std::setw(10) << row.result->fills.size() << std::setw(20)
+                      << row.result->finalPortfolio.settledFunds.value();
+        } else {
+            std::cout << std::setw(30) << ("error: " + row.error);
+        }
+        std::cout << std::chrono::duration<double>(row.runTime).count() << std::endl;
+    }
+
+    // Replay one point of the grid under 32 fill-rate streams to see how much of its result is
+    // the luck of the fills. Rerun any trial alone by setting fillRateSeed and trialIndex
+    RunParams<ConstantDistribution> trialParams = setRunParams({Ticks{100}, 10'000'000ULL});
+    trialParams.fillRateSeed = 20251024;
+    trialParams.verbosityLevel = VerbosityLevel::DETAILED;
+    sweep.runFillModelTrials(trialParams, 32, [](const RunParams<ConstantDistribution>& params) {
+        return std::make_unique<PassiveBidStrategy>(params, Ticks{100});
+    });
+
+    // Play the first morning once and pause at noon New York time (16:00 UTC), then continue
+    // the paused run under each latency in parallel without replaying the morning
+    const RunParams<ConstantDistribution> prefixParams = setRunParams({Ticks{100}, 10'000'000ULL});
+    PassiveBidStrategy prefixStrategy(prefixParams, Ticks{100});
+    Engine<10, 1, ConstantDistribution> prefixEngine(
+        std::make_unique<MarketDataShared<10, 1>>(store, prefixParams.marketData), prefixParams);
+    prefixEngine.runUntil(prefixStrategy, TimeStamp{1'761'321'600'000'000'000ULL});
+    const EngineSnapshot noon = prefixEngine.snapshot(prefixStrategy);
+
+    std::vector<SweepParameters> branches;
+    for (std::uint64_t latency : {1'000'000ULL, 10'000'000ULL, 60'000'000ULL}) {
+        branches.push_back({Ticks{100}, latency});
+    }
+    auto branchTable = sweep.runFrom(
+        noon, branches,
+        [](const SweepParameters& parameters) { return setRunParams(parameters); },
+        [](const SweepParameters& parameters, const RunParams<ConstantDistribution>& params) {
+            return std::make_unique<PassiveBidStrategy>(params, parameters.limitOffset);
+        });
+
+    std::cout << "\nBranches from noon (snapshot of " << noon.size() << " bytes)\n";
+    for (const auto& row : branchTable.rows) {
+        std::cout << std::left << std::setw(16) << row.parameters.latencyNanoseconds;
+        if (row.result) {
+            std::cout << std::setw(10) << row.result->fills.size()
+                      << row.result->finalPortfolio.settledFunds.value() << std::endl;
+        } else {
+            std::cout << "error: " << row.error << std::endl;
+        }
+    }
+
+    return 0;
+}
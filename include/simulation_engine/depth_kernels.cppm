@@ -0,0 +1,174 @@
+// depth_kernels.cppm
+export module simulation_engine:depth_kernels;
+
+import :quote;
+import :types;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief One side of a quote with running totals, the input of the depth kernels
+ * @details
+ * Built once per quote and side by the matching loop and shared by every order evaluated against
+ * that side; the prices and sizes are views of the quote, which must outlive the ladder. Every
+ * kernel below is a fixed-trip-count pass over the `depth` levels with no data-dependent
+ * branches: level boundaries are found from a comparison mask or count rather than an early exit,
+ * so the compiler can unroll and vectorize each kernel for the instantiated depth, and the
+ * notional of whole levels is read off the running totals instead of being summed per order.
+ */
+template <std::size_t depth>
+struct DepthLadder {
+    std::span<const Ticks, depth> prices;
+    std::span<const Ticks, depth> sizes;
+    std::array<std::int64_t, depth> cumulativeSizes{};     // Size of this level and all better ones
+    std::array<std::int64_t, depth> cumulativeNotional{};  // Price times size, summed likewise
+};
+
+template <std::size_t depth>
+inline DepthLadder<depth> makeDepthLadder(std::span<const Ticks, depth> prices,
+    std::span<const Ticks, depth> sizes) {
+    DepthLadder<depth> ladder{prices, sizes};
+    std::int64_t runningSize = 0;
+    std::int64_t runningNotional = 0;
+    for (std::size_t level = 0; level < depth; ++level) {
+        runningSize += sizes[level].value();
+        runningNotional += prices[level].value() * sizes[level].value();
+        ladder.cumulativeSizes[level] = runningSize;
+        ladder.cumulativeNotional[level] = runningNotional;
+    }
+    return ladder;
+}
+
+/**
+ * @brief The side of quote an order with the given instruction trades against.
+ */
+template <std::size_t depth>
+inline DepthLadder<depth> makeDepthLadder(const Quote<depth>& quote,
+    OrderInstruction orderInstruction) {
+    return (orderInstruction == OrderInstruction::Buy)
+        ? makeDepthLadder<depth>(quote.getAsks(), quote.getAskSizes())
+        : makeDepthLadder<depth>(quote.getBids(), quote.getBidSizes());
+}
+
+/**
+ * @brief Number of leading levels a limit order can trade against.
+ * @details A buy crosses ask levels priced at or below its limit and a sell crosses bid levels
+ * priced at or above it; the count stops at the first level that does not cross.
+ */
+template <std::size_t depth>
+inline std::size_t crossingLevels(const DepthLadder<depth>& ladder,
+    OrderInstruction orderInstruction,
+    Ticks limit) {
+    static_assert(depth < 64, "crossing mask holds one bit per level");
+    const std::int64_t sign = (orderInstruction == OrderInstruction::Buy) ? 1 : -1;
+    const std::int64_t signedLimit = sign * limit.value();
+
+    std::uint64_t misses = std::uint64_t{1} << depth;
+    for (std::size_t level = 0; level < depth; ++level) {
+        const bool crosses = sign * ladder.prices[level].value() <= signedLimit;
+        misses |= std::uint64_t{!crosses} << level;
+    }
+    return static_cast<std::size_t>(std::countr_zero(misses));
+}
+
+/**
+ * @brief Total size of the first levels of the ladder.
+ */
+template <std::size_t depth>
+inline std::int64_t sharesThrough(const DepthLadder<depth>& ladder, std::size_t levels) {
+    return (levels == 0) ? 0 : ladder.cumulativeSizes[levels - 1];
+}
+
+/**
+ * @brief Shares a limit order can trade against the ladder.
+ */
+template <std::size_t depth>
+inline std::int64_t sharesAvailable(const DepthLadder<depth>& ladder,
+    OrderInstruction orderInstruction,
+    Ticks limit) {
+    return sharesThrough(ladder, crossingLevels(ladder, orderInstruction, limit));
+}
+
+/**
+ * @brief Shares a limit order can trade, for many orders on the same side of one quote.
+ * @details The ladder and its running totals are built once and shared; each order then costs
+ * one masked pass over the levels.
+ * @param limits Limit price of each order.
+ * @param out Receives the shares available to each order; must be as long as limits.
+ */
+template <std::size_t depth>
+inline void sharesAvailable(const DepthLadder<depth>& ladder,
+    OrderInstruction orderInstruction,
+    std::span<const Ticks> limits,
+    std::span<std::int64_t> out) {
+    for (std::size_t i = 0; i < limits.size(); ++i) {
+        out[i] = sharesAvailable(ladder, orderInstruction, limits[i]);
+    }
+}
+
+/**
+ * @brief Shares a market order can trade: the whole ladder.
+ */
+template <std::size_t depth>
+inline std::int64_t totalShares(const DepthLadder<depth>& ladder) {
+    return ladder.cumulativeSizes[depth - 1];
+}
+
+/**
+ * @brief Number of leading levels a quantity consumes completely.
+ */
+template <std::size_t depth>
+inline std::size_t fullLevels(const DepthLadder<depth>& ladder, std::int64_t quantity) {
+    std::size_t levels = 0;
+    for (std::size_t level = 0; level < depth; ++level) {
+        levels += (ladder.cumulativeSizes[level] <= quantity) ? 1 : 0;
+    }
+    return levels;
+}
+
+/**
+ * @brief Notional of the leading levels a quantity consumes completely.
+ * @details The partially consumed level is left out, matching the equity estimate of a market
+ * order.
+ */
+template <std::size_t depth>
+inline Ticks fullLevelNotional(const DepthLadder<depth>& ladder, std::int64_t quantity) {
+    const std::size_t levels = fullLevels(ladder, quantity);
+    return Ticks{(levels == 0) ? 0 : ladder.cumulativeNotional[levels - 1]};
+}
+
+/**
+ * @brief Average price of taking shares from the top of the ladder.
+ * @details The levels taken completely come from the running totals; only the partially taken
+ * level is priced on its own.
+ * @return 0 if nothing can be taken.
+ */
+template <std::size_t depth>
+inline Ticks averageFillPrice(const DepthLadder<depth>& ladder, std::int64_t shares) {
+    const std::size_t levels = fullLevels(ladder, shares);
+    std::int64_t notional = (levels == 0) ? 0 : ladder.cumulativeNotional[levels - 1];
+    std::int64_t taken = sharesThrough(ladder, levels);
+    if (levels < depth && taken < shares) {
+        notional += ladder.prices[levels].value() * (shares - taken);
+        taken = shares;
+    }
+    return (taken > 0) ? Ticks{notional / taken} : Ticks{0};
+}
+
+/**
+ * @brief Average fill prices of many orders taking from the same side of one quote.
+ * @param shares Shares each order takes.
+ * @param out Receives the average price of each order; must be as long as shares.
+ */
+template <std::size_t depth>
+inline void averageFillPrice(const DepthLadder<depth>& ladder,
+    std::span<const std::int64_t> shares,
+    std::span<Ticks> out) {
+    for (std::size_t i = 0; i < shares.size(); ++i) {
+        out[i] = averageFillPrice(ladder, shares[i]);
+    }
+}
+
+}  // namespace sim
@@ -4,14 +4,21 @@ export module simulation_engine:engine;
 import std;
 
 import :probability_distributions;
+import :random_streams;
+import :depth_kernels;
+import :engine_policies;
+import :event_queue;
 import :market_data;
 import :order_placement;
+import :pending_order_store;
 import :portfolio;
 import :run_params;
+import :snapshot;
 import :statistics;
 import :strategy_interface;
 import :types;
 import :quote;
+import :resting_order_book;
 
 export namespace sim {
 
@@ -20,6 +27,8 @@ struct Result {
     std::vector<Fill> fills;  // Vector of all fills during simulation
     Portfolio<numberOfSymbols, Distribution> finalPortfolio;  // Final portfolio state
     std::size_t quotesProcessed{0};                           // Total number of quotes processed
+    RunMetrics metrics;                                       // Headline numbers of the run
+    std::string marketDataError;  // Set if market data failed to load; the run stopped there
 };
 
 struct ExecutionResult {
@@ -30,9 +39,12 @@ struct ExecutionResult {
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
 class Engine final {
+    static_assert(SamplingDistribution<Distribution>,
+        "Fill rates must be drawn from a SamplingDistribution");
+
    public:
     template <std::size_t D, std::uint16_t N, typename Dist>
-    friend class IStrategy;
+    friend class StrategyBase;
     /**
      * @brief Construct a new Engine object.
      * @details Initializes the simulation environment with market data providers and execution
@@ -55,6 +67,91 @@ class Engine final {
         IStrategy<depth, numberOfSymbols, Distribution>& strat,
         std::ostream& out = std::cout);
 
+    /**
+     * @brief run with the strategy's callbacks bound at compile time.
+     * @details
+     * Chosen whenever a strategy is passed as its own type rather than as an IStrategy. The loop
+     * is instantiated for that type and calls its onSymbolUpdate, onFill and onEnd directly, so
+     * for a final class, or one not derived from IStrategy at all, they are inlined into the loop
+     * and optimized with it. The IStrategy overload above is this loop compiled once for virtual
+     * dispatch.
+     *
+     * Policies selects the features the loop is compiled with, e.g. run<RawThroughput>(strat)
+     * for a loop without trading hours, margin, settlement or sampled fill rates. The default,
+     * FullRealism, runs everything RunParams asks for.
+     */
+    template <EnginePolicySet Policies = FullRealism,
+        TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+    Result<numberOfSymbols, Distribution> run(Strategy& strat, std::ostream& out = std::cout);
+
+    /**
+     * @brief Run the simulation up to a point in time and pause there.
+     * @details Applies every quote timestamped before stopTime and returns without ending the
+     * run, so it can be snapshotted or forked, then continued with runUntil, run or finish.
+     * Every part of one run should use the same Policies.
+     * @param strat Reference to the trading strategy to be executed.
+     * @param stopTime Quotes at or after this time are left for later.
+     * @return False once the market data is exhausted.
+     */
+    template <EnginePolicySet Policies = FullRealism,
+        TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+    bool runUntil(Strategy& strat, TimeStamp stopTime);
+
+    /**
+     * @brief End the run at the current quote and report it, as run does after the last quote.
+     * @details The fills move into the result, so the run cannot be continued afterwards.
+     * @param strat Reference to the trading strategy that was executed.
+     * @param out The output stream for logging.
+     * @return A Result struct containing fills, final portfolio, and processing stats.
+     */
+    template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+    Result<numberOfSymbols, Distribution> finish(Strategy& strat, std::ostream& out = std::cout);
+
+    /**
+     * @brief Capture the complete state of a paused run.
+     * @details Covers the market data position and market state, the portfolio, the working and
+     * in-flight orders, the scheduled cancels, replaces, arrivals and fill notifications, the
+     * fill-rate seed and latency streams, the statistics accumulators, the fills so far and,
+     * through IStrategy::saveState, the strategy.
+     * @param strat The strategy attached to the run.
+     * @return The snapshot, which can be saved with saveSnapshot.
+     */
+    template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+    EngineSnapshot snapshot(const Strategy& strat) const;
+
+    /**
+     * @brief Continue from a snapshot instead of from the start of the market data.
+     * @details
+     * The engine must be over the same market data files, and sample latencies the same way, as
+     * the engine the snapshot was taken from. Its fill-rate seed and trial are adopted, so the
+     * run makes the draws the original would have made. strat is attached and its state loaded
+     * with IStrategy::loadState; it may differ from the original strategy as long as the two
+     * agree on that state, through saveState and loadState. Continue with runUntil or run.
+     * @param snapshot The snapshot to continue from.
+     * @param strat The strategy that continues the run.
+     * @return False if the snapshot belongs to a different engine or is malformed, in which case
+     * the engine is left partly restored and should be discarded.
+     */
+    template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+    bool restore(const EngineSnapshot& snapshot, Strategy& strat);
+
+    /**
+     * @brief Clone a paused run into a new engine that continues independently.
+     * @details
+     * Restores a snapshot of this run into an engine with the same RunParams. Only the mutable
+     * state is copied: give each branch a MarketDataShared cursor over the same SharedQuoteStore
+     * and the quotes are shared read-only by every branch, as are the latency models. The
+     * branches can then run on separate threads.
+     * @param branchMarketData Market data over the same files for the branch.
+     * @param branchStrategy The strategy that continues in the branch; the state of the current
+     * strategy is loaded into it.
+     * @return The branch, or null if the run was not started with an IStrategy or the state
+     * could not be restored.
+     */
+    std::unique_ptr<Engine> fork(
+        std::unique_ptr<IMarketData<depth, numberOfSymbols>> branchMarketData,
+        IStrategy<depth, numberOfSymbols, Distribution>& branchStrategy) const;
+
     /**
      * @brief Calculate the total mark-to-market value of the portfolio.
      * @details Combines cash balances and the value of open positions based on current market
@@ -108,22 +205,49 @@ class Engine final {
    private:
     RunParams<Distribution> params_;
     std::unique_ptr<IMarketData<depth, numberOfSymbols>> marketData;
-    IStrategy<depth, numberOfSymbols, Distribution>* strategy{nullptr};
+    IStrategy<depth, numberOfSymbols, Distribution>* strategy{nullptr};  // Null for other types
     Portfolio<numberOfSymbols, Distribution> portfolio;
     Distribution buyFillRateDistribution;
     Distribution sellFillRateDistribution;
-    std::mt19937 randomNumberGenerator;
+    std::array<PhiloxKey, numberOfSymbols> fillRateKeys{};  // Fill-rate stream key per symbol
     Statistics<depth, Distribution> statistics;
     VerbosityLevel verbosityLevel;
     int statisticsUpdateRateSeconds;
     std::uint8_t leverageFactor;
-    std::vector<PendingOrder> pendingOrders;
-    std::vector<CancelOrder> pendingCancels;
-    std::vector<ReplaceOrder> pendingReplaces;
-    std::vector<PendingNotification> pendingNotifications;
+    PendingOrderStore pendingOrders;    // Orders working at the exchange
+    PendingOrderStore inFlightOrders;   // Orders sent but still within the send latency
+    EventQueue scheduledActions;        // Latency-delayed cancels, replaces and order arrivals
+    EventQueue scheduledNotifications;  // Fill notifications waiting out the receive latency
+    RestingOrderBook<numberOfSymbols> restingOrders;  // Price index of pendingOrders
+    std::array<bool, numberOfSymbols> symbolsToMatch{};  // Symbols with new or changed orders
+    std::vector<OrderId> marketableOrders;  // Scratch buffer of processPendingBuySellOrders
+
+    /**
+     * @brief Scratch buffers of processPendingBuySellOrders
+     * @details The marketable orders are laid out grouped by symbol and side, in placement order
+     * within each group, so that each group is one contiguous span for the batched depth
+     * kernels. positions maps the placement order back to that layout.
+     */
+    struct MatchBuffers {
+        std::vector<std::size_t> positions;  // Grouped position of each of marketableOrders
+        std::vector<OrderId> orderIds;
+        std::vector<Ticks> limits;
+        std::vector<std::int64_t> shares;  // Shares available, then shares to fill
+        std::vector<Ticks> prices;         // Average fill price of the shares to fill
+
+        void resize(std::size_t numberOfOrders) {
+            positions.resize(numberOfOrders);
+            orderIds.resize(numberOfOrders);
+            limits.resize(numberOfOrders);
+            shares.resize(numberOfOrders);
+            prices.resize(numberOfOrders);
+        }
+    };
+    MatchBuffers matchBuffers;
     std::uint64_t sendLatencyNs;
     std::uint64_t receiveLatencyNs;
-    std::uint64_t totalLatencyNs;
+    std::optional<SampleBuffer<AnyDistribution>> sendLatencySamples;     // Set for sampled latency
+    std::optional<SampleBuffer<AnyDistribution>> receiveLatencySamples;  // Set for sampled latency
     std::vector<Fill> fills;
     std::size_t quotesProcessed{0};
     OrderId nextOrderId{1};
@@ -131,32 +255,45 @@ class Engine final {
 
     Ticks estimateTotalOrderPrice(NewOrder order);
 
-    Quantity numberOfSharesToFillForLimitOrder(const Quote<depth>& quote,
-        OrderInstruction orderInstruction,
-        Ticks price,
-        Quantity desiredNumberOfShares);
+    /**
+     * @brief Shares one attempt fills: fillRate percent of what the order can reach.
+     * @param numberOfSharesAvailable Shares on the levels the order can trade against.
+     */
+    Quantity numberOfSharesToFill(std::int64_t numberOfSharesAvailable,
+        const NewOrder& order,
+        double fillRate);
 
-    Quantity numberOfSharesToFillForMarketOrder(const Quote<depth>& quote,
-        OrderInstruction orderInstruction,
-        Quantity desiredNumberOfShares);
+    /**
+     * @brief Draw the fill rate of one attempt to fill an order.
+     * @details The draw comes from the stream of (seed, trial, symbol, order id, attempt), so it
+     * is the same in every replay of the run.
+     */
+    double determineFillRate(const NewOrder& order, std::uint32_t fillAttempt);
 
-    double determineFillRate(std::mt19937& rng, OrderInstruction orderInstruction);
+    /**
+     * @brief Latency of the next message to or from the exchange.
+     * @details The fixed latency of RunParams, or the next draw of its latency distribution.
+     */
+    std::uint64_t nextSendLatency();
+    std::uint64_t nextReceiveLatency();
 
-    Ticks averageExecutionPrice(const Quote<depth>& quote,
-        Quantity numberOfShares,
-        OrderInstruction orderInstruction);
+    // Orders, cancels and replaces take effect a full round trip after they are sent
+    std::uint64_t nextRoundTripLatency();
 
     /**
      * @brief Deliver execution and order updates to the strategy.
      * @details Respects receive latency by only notifying the strategy once the time has passed.
      * @param strategy The strategy instance to notify.
      */
-    void processPendingNotifications(IStrategy<depth, numberOfSymbols, Distribution>& strategy);
+    template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+    void processPendingNotifications(Strategy& strategy);
 
     /**
      * @brief Handle daily clearing and settlement logic.
-     * @details Updates settled cash balances and resets daily trading limits.
+     * @details Updates settled cash balances and accrues interest on loans, as far as Policies
+     * settles funds and checks margin.
      */
+    template <EnginePolicySet Policies>
     void processSettlements();
 
     /**
@@ -175,27 +312,52 @@ class Engine final {
 
     /**
      * @brief Orchestrate the processing of all queued order actions.
-     * @details Coordinates the execution of new, replace, and cancel orders.
+     * @details Applies every cancel, replace and order arrival that is due, then offers the
+     * working orders to the market. Fill notifications wait for processPendingNotifications, so
+     * the strategy never hears of earlier fills before this quote is matched.
+     * @param updatedSymbol The symbol whose quote changed.
      */
-    void processPendingOrders();
+    template <EnginePolicySet Policies>
+    void processPendingOrders(std::uint16_t updatedSymbol);
 
     /**
-     * @brief Process new Buy and Sell orders that have arrived after latency.
+     * @brief Pop and apply every cancel, replace and order arrival due at the current timestamp.
      */
-    void processPendingBuySellOrders();
+    void processDueActions();
 
     /**
-     * @brief Process queued requests to modify existing orders.
+     * @brief Apply a due cancel, replace or order arrival.
      */
-    void processPendingReplaceOrders();
+    void applyScheduledAction(const ScheduledAction& action);
 
     /**
-     * @brief Process queued requests to remove existing orders.
+     * @brief Offer the working orders that can trade to the current market.
+     * @details Only the symbol that just updated, and symbols whose orders arrived or changed
+     * on this quote, are matched, and of those only orders whose limit crosses the opposite
+     * best price are visited. They are offered in OrderId order.
+     * @param updatedSymbol The symbol whose quote changed.
      */
-    void processPendingCancelOrders();
+    template <EnginePolicySet Policies>
+    void processPendingBuySellOrders(std::uint16_t updatedSymbol);
+
+    /**
+     * @brief Apply a replace request that has arrived at the exchange.
+     */
+    void applyReplace(const ReplaceOrder& replaceOrder);
+
+    /**
+     * @brief Apply a cancel request that has arrived at the exchange.
+     */
+    void applyCancel(const CancelOrder& cancelOrder);
+
+    /**
+     * @brief Move an order that has arrived at the exchange from in flight to working.
+     */
+    void activateOrder(OrderId orderId);
 
     /**
      * @brief Evaluate the portfolio against margin maintenance requirements.
+     * @details Uses the portfolio's marked values, which are kept current one symbol at a time.
      */
     void checkMarginRequirement();
 
@@ -205,22 +367,48 @@ class Engine final {
     void executeMarginCall();
 
     /**
-     * @brief Core simulation logic runner.
+     * @brief Attach a strategy and mark every symbol at the current market state.
+     * @details The market state may already hold quotes, e.g. after a seek or a restore.
+     */
+    template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+    void attach(Strategy& strategy);
+
+    /**
+     * @brief Core simulation step, for the quote nextMarketState just applied.
      * @param strategy The strategy being tested.
-     * @return The final results of the simulation.
      */
-    Result<numberOfSymbols, Distribution> simulate(
-        IStrategy<depth, numberOfSymbols, Distribution>& strategy);
+    template <EnginePolicySet Policies,
+        TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+    void processQuote(Strategy& strategy);
+
+    /**
+     * @brief Write or read everything in a snapshot except the strategy's state.
+     */
+    void saveEngineState(SnapshotWriter& out) const;
+    bool restoreEngineState(SnapshotReader& in);
 
     /**
-     * @brief Attempt to match a single order against the current market quote.
-     * @details Simulates the exchange matching engine logic and fill rate probabilities.
+     * @brief Snapshot and restore a latency buffer; the flag records whether there is one.
+     */
+    static void saveLatencySamples(SnapshotWriter& out,
+        const std::optional<SampleBuffer<AnyDistribution>>& samples);
+    static bool loadLatencySamples(SnapshotReader& in,
+        std::optional<SampleBuffer<AnyDistribution>>& samples);
+
+    /**
+     * @brief Execute one attempt to match an order against the current market quote.
+     * @details The attempt has already been sized and priced against the quote by the matching
+     * loop; this books the fill and queues its notification.
      * @param newOrder The order to be executed.
      * @param sendTs The time the order arrived at the exchange.
-     * @param quote The current market depth for matching.
+     * @param numberOfSharesToFill Shares this attempt fills, possibly none.
+     * @param avgExecPrice Average price of those shares.
      * @return ExecutionResult containing any generated fills and remaining quantity.
      */
-    ExecutionResult tryExecute(const NewOrder& newOrder, TimeStamp sendTs);
+    ExecutionResult tryExecute(const NewOrder& newOrder,
+        TimeStamp sendTs,
+        Quantity numberOfSharesToFill,
+        Ticks avgExecPrice);
 
     /**
      * @brief Check if the simulation time falls within allowed trading hours.
@@ -237,4 +425,287 @@ class Engine final {
     bool isInsideDST(TimeStamp currentTime) const;
 };
 
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <EnginePolicySet Policies, TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+Result<numberOfSymbols, Distribution> Engine<depth, numberOfSymbols, Distribution>::run(
+    Strategy& strategy,
+    std::ostream& out) {
+    attach(strategy);
+
+    // Process market data
+    while (marketData->nextMarketState()) {
+        processQuote<Policies>(strategy);
+    }
+
+    return finish(strategy, out);
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <EnginePolicySet Policies, TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+bool Engine<depth, numberOfSymbols, Distribution>::runUntil(Strategy& strategy,
+    TimeStamp stopTime) {
+    attach(strategy);
+
+    while (marketData->nextMarketState(stopTime)) {
+        processQuote<Policies>(strategy);
+    }
+
+    return marketData->hasNextMarketState();
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+Result<numberOfSymbols, Distribution> Engine<depth, numberOfSymbols, Distribution>::finish(
+    Strategy& strategy,
+    std::ostream& out) {
+    attach(strategy);
+    strategy.onEnd();
+
+    // Update final statistics including interest owed
+    statistics.updateInterestOwed(portfolio.interestOwed);
+
+    Result<numberOfSymbols, Distribution> result{std::move(fills), portfolio, quotesProcessed};
+    result.metrics = statistics.metrics();
+    result.marketDataError = marketData->loadError();
+    statistics.outputSummary(out, verbosityLevel);
+    if (!result.marketDataError.empty()) {
+        out << "\nMarket data failed to load, the run is incomplete: " << result.marketDataError
+            << std::endl;
+    }
+    if (verbosityLevel != VerbosityLevel::MINIMAL) {
+        marketData->outputLoadReport(out);
+    }
+    return result;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+EngineSnapshot Engine<depth, numberOfSymbols, Distribution>::snapshot(
+    const Strategy& strategy) const {
+    SnapshotWriter out;
+    saveEngineState(out);
+    strategy.saveState(out);
+    return EngineSnapshot(out.release());
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+bool Engine<depth, numberOfSymbols, Distribution>::restore(const EngineSnapshot& snapshot,
+    Strategy& strategy) {
+    SnapshotReader in(snapshot.bytes());
+    if (!restoreEngineState(in)) return false;
+
+    attach(strategy);
+    return strategy.loadState(in) && in.atEnd();
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+void Engine<depth, numberOfSymbols, Distribution>::attach(Strategy& strategy) {
+    if constexpr (std::derived_from<Strategy, IStrategy<depth, numberOfSymbols, Distribution>>) {
+        this->strategy = &strategy;
+    } else {
+        this->strategy = nullptr;
+    }
+    strategy.setEngine(this);
+
+    // The market state may already hold quotes, e.g. after a seek
+    for (std::uint16_t symbol = 0; symbol < numberOfSymbols; ++symbol) {
+        portfolio.markToMarket(symbol, marketData->bestBid(symbol), marketData->bestAsk(symbol));
+    }
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <EnginePolicySet Policies, TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+void Engine<depth, numberOfSymbols, Distribution>::processQuote(Strategy& strategy) {
+    ++quotesProcessed;
+
+    // Every phase below only revisits state that depends on the symbol that changed, which with
+    // a single symbol is known at compile time
+    std::uint16_t updatedSymbol = 0;
+    if constexpr (numberOfSymbols > 1) {
+        updatedSymbol = marketData->lastUpdatedSymbol();
+    }
+
+    // Send strategy market data
+    strategy.onSymbolUpdate(marketData->currentMarketState(), updatedSymbol);
+
+    // Revalue the position in the updated symbol only
+    portfolio.markToMarket(updatedSymbol, marketData->bestBid(updatedSymbol),
+        marketData->bestAsk(updatedSymbol));
+
+    // Check margin requirements and execute margin calls if necessary
+    if constexpr (Policies::Margin::checksMargin) {
+        checkMarginRequirement();
+    }
+
+    // Try to fill orders after 'sendLatency' + 'receiveLatency' has
+    // passed since order was sent from strategy.
+    processPendingOrders<Policies>(updatedSymbol);
+
+    // Send fill notifications to strategy after 'receiveLatency' time has passed since fill.
+    processPendingNotifications(strategy);
+
+    // Process settlements each morning after 9am
+    processSettlements<Policies>();
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <EnginePolicySet Policies>
+void Engine<depth, numberOfSymbols, Distribution>::processPendingOrders(
+    std::uint16_t updatedSymbol) {
+    processDueActions();
+    processPendingBuySellOrders<Policies>(updatedSymbol);
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <EnginePolicySet Policies>
+void Engine<depth, numberOfSymbols, Distribution>::processPendingBuySellOrders(
+    std::uint16_t updatedSymbol) {
+    // The quote counts as changed even when nothing can trade on it yet, so orders resting on
+    // this symbol are matched against it at the next tradable quote of any symbol
+    if constexpr (numberOfSymbols > 1) {
+        symbolsToMatch[updatedSymbol] = true;
+    }
+
+    // Every working order has passed its send latency; they only trade within trading hours
+    if (pendingOrders.empty()) return;
+    if constexpr (Policies::TradingCalendar::restrictsTradingHours) {
+        if (!canTrade(marketData->currentTimeStamp())) return;
+    }
+
+    const MarketState<depth, numberOfSymbols>& marketState = marketData->currentMarketState();
+
+    marketableOrders.clear();
+    if constexpr (numberOfSymbols == 1) {
+        // The only symbol is the one that updated
+        symbolsToMatch[0] = false;
+        const Quote<depth>& quote = marketState.getQuote(0);
+        restingOrders.collectMarketable(0, quote.bid(0), quote.ask(0), marketableOrders);
+    } else {
+        for (std::uint16_t symbol = 0; symbol < numberOfSymbols; ++symbol) {
+            if (!symbolsToMatch[symbol]) continue;
+            symbolsToMatch[symbol] = false;
+
+            const Quote<depth>& quote = marketState.getQuote(symbol);
+            restingOrders.collectMarketable(symbol, quote.bid(0), quote.ask(0),
+                marketableOrders);
+        }
+    }
+
+    // Offer orders in the order they were placed
+    std::ranges::sort(marketableOrders);
+
+    // Fills never change the quote, so every order on the same symbol and side trades against
+    // one ladder. The orders are grouped by ladder with a counting sort that keeps placement
+    // order within each group, and each group is sized and priced by the batched kernels.
+    constexpr std::size_t numberOfLadders = 2 * numberOfSymbols;
+    auto ladderIndex = [](const NewOrder& order) {
+        return 2 * std::size_t{order.symbol} + (order.instruction == OrderInstruction::Buy ? 0 : 1);
+    };
+
+    const std::size_t numberOfOrders = marketableOrders.size();
+    std::array<std::size_t, numberOfLadders + 1> groupStart{};
+    for (OrderId orderId : marketableOrders) {
+        ++groupStart[ladderIndex(pendingOrders.find(orderId)->order) + 1];
+    }
+    std::partial_sum(groupStart.begin(), groupStart.end(), groupStart.begin());
+
+    matchBuffers.resize(numberOfOrders);
+    std::array<std::size_t, numberOfLadders> nextPosition;
+    std::copy_n(groupStart.begin(), numberOfLadders, nextPosition.begin());
+    for (std::size_t i = 0; i < numberOfOrders; ++i) {
+        const NewOrder& order = pendingOrders.find(marketableOrders[i])->order;
+        const std::size_t position = nextPosition[ladderIndex(order)]++;
+        matchBuffers.positions[i] = position;
+        matchBuffers.orderIds[position] = marketableOrders[i];
+        matchBuffers.limits[position] = order.price;
+    }
+
+    for (std::size_t ladderId = 0; ladderId < numberOfLadders; ++ladderId) {
+        const std::size_t first = groupStart[ladderId];
+        const std::size_t count = groupStart[ladderId + 1] - first;
+        if (count == 0) continue;
+
+        const OrderInstruction instruction =
+            (ladderId % 2 == 0) ? OrderInstruction::Buy : OrderInstruction::Sell;
+        const DepthLadder<depth> ladder = makeDepthLadder(
+            marketState.getQuote(static_cast<std::uint16_t>(ladderId / 2)), instruction);
+        const std::span<std::int64_t> shares(matchBuffers.shares.data() + first, count);
+        sharesAvailable(ladder, instruction,
+            std::span<const Ticks>(matchBuffers.limits.data() + first, count), shares);
+
+        for (std::size_t k = 0; k < count; ++k) {
+            PendingOrder* pendingOrder = pendingOrders.find(matchBuffers.orderIds[first + k]);
+            const std::uint32_t fillAttempt = pendingOrder->fillAttempts++;
+            const NewOrder& order = pendingOrder->order;
+
+            // A market order can take every level
+            if (order.orderType == OrderType::Market) shares[k] = totalShares(ladder);
+
+            // Without sampling every attempt takes all the liquidity it can reach
+            double fillRate = 100.0;
+            if constexpr (Policies::FillModel::samplesFillRates) {
+                fillRate = determineFillRate(order, fillAttempt);
+            }
+            shares[k] = numberOfSharesToFill(shares[k], order, fillRate).value();
+        }
+        averageFillPrice(ladder, std::span<const std::int64_t>(shares),
+            std::span<Ticks>(matchBuffers.prices.data() + first, count));
+    }
+
+    // Fill in placement order, so the portfolio sees the fills in the order they happen
+    for (std::size_t i = 0; i < numberOfOrders; ++i) {
+        const OrderId orderId = marketableOrders[i];
+        const std::size_t position = matchBuffers.positions[i];
+        PendingOrder* pendingOrder = pendingOrders.find(orderId);
+
+        ExecutionResult result = tryExecute(pendingOrder->order, pendingOrder->sendTime,
+            Quantity{static_cast<std::uint32_t>(matchBuffers.shares[position])},
+            matchBuffers.prices[position]);
+        if (result.isComplete) {
+            // Order is complete, remove from pending
+            restingOrders.remove(pendingOrder->order);
+            pendingOrders.erase(orderId);
+        } else if (result.remainingOrder.quantity.value() != 0) {
+            // Order partially filled, update remaining quantity
+            pendingOrder->order = result.remainingOrder;
+        }
+    }
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <EnginePolicySet Policies>
+void Engine<depth, numberOfSymbols, Distribution>::processSettlements() {
+    // Interest on loans accrues on the same daily cycle as settlement
+    if constexpr (Policies::Settlement::settlesFunds || Policies::Margin::checksMargin) {
+        // Only process settlements once per day after 9am
+        const TimeStamp currentTime = marketData->currentTimeStamp();
+        if (!isTimeForSettlement(currentTime)) return;
+
+        if constexpr (Policies::Settlement::settlesFunds) {
+            // Process unsettled funds settlements
+            portfolio.processSettlements(currentTime);
+        }
+        if constexpr (Policies::Margin::checksMargin) {
+            // Calculate and apply daily interest on outstanding loans
+            portfolio.calculateDailyInterest(currentTime);
+        }
+
+        lastSettlementDate = currentTime;
+    }
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+template <TradingStrategy<depth, numberOfSymbols, Distribution> Strategy>
+void Engine<depth, numberOfSymbols, Distribution>::processPendingNotifications(Strategy& strategy) {
+    // Orders the strategy places from onFill are queued as actions and so reach the market on a
+    // later quote, however short the send latency
+    const TimeStamp currentTime = marketData->currentTimeStamp();
+    while (scheduledNotifications.due(currentTime)) {
+        const ScheduledEvent event = scheduledNotifications.pop();
+        strategy.onFill(std::get<PendingNotification>(event.action).fill);
+    }
+}
+
 }  // namespace sim
@@ -0,0 +1,104 @@
+// engine_policies.cppm
+export module simulation_engine:engine_policies;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief Trading calendar policies
+ * @details ExchangeHours restricts matching to the trading hours of RunParams when its
+ * enforceTradingHours is set. AlwaysOpen matches around the clock and never looks at the time.
+ */
+struct ExchangeHours {
+    static constexpr bool restrictsTradingHours = true;
+};
+
+struct AlwaysOpen {
+    static constexpr bool restrictsTradingHours = false;
+};
+
+/**
+ * @brief Margin policies
+ * @details MarginAccount checks the maintenance requirement on every quote, liquidating on a
+ * violation, and accrues daily interest on loans. CashAccount does neither, for runs that cannot
+ * borrow, e.g. with a leverageFactor of 1 and no shorting.
+ */
+struct MarginAccount {
+    static constexpr bool checksMargin = true;
+};
+
+struct CashAccount {
+    static constexpr bool checksMargin = false;
+};
+
+/**
+ * @brief Settlement policies
+ * @details NextDaySettlement moves matured sale proceeds to settled funds each morning.
+ * NoSettlement leaves them unsettled; orders are checked against equity, not settled funds, so
+ * this only changes how the cash is classified.
+ */
+struct NextDaySettlement {
+    static constexpr bool settlesFunds = true;
+};
+
+struct NoSettlement {
+    static constexpr bool settlesFunds = false;
+};
+
+/**
+ * @brief Fill model policies
+ * @details SampledFillRates draws the share of the available liquidity each fill attempt gets
+ * from the fill-rate distributions of RunParams. CompleteFills gives every attempt all of it,
+ * up to the order quantity, without drawing anything.
+ */
+struct SampledFillRates {
+    static constexpr bool samplesFillRates = true;
+};
+
+struct CompleteFills {
+    static constexpr bool samplesFillRates = false;
+};
+
+/**
+ * @brief The features an engine run is compiled with, one policy of each kind above
+ * @details
+ * Passed to Engine::run and Engine::runUntil as a template argument. Features a policy turns off
+ * are removed from the simulation loop by if constexpr rather than skipped at run time, so they
+ * cost nothing per quote whatever RunParams says.
+ */
+template <typename TradingCalendarPolicy,
+    typename MarginPolicy,
+    typename SettlementPolicy,
+    typename FillModelPolicy>
+struct EnginePolicies {
+    using TradingCalendar = TradingCalendarPolicy;
+    using Margin = MarginPolicy;
+    using Settlement = SettlementPolicy;
+    using FillModel = FillModelPolicy;
+};
+
+template <typename Policies>
+concept EnginePolicySet = requires {
+    { Policies::TradingCalendar::restrictsTradingHours } -> std::convertible_to<bool>;
+    { Policies::Margin::checksMargin } -> std::convertible_to<bool>;
+    { Policies::Settlement::settlesFunds } -> std::convertible_to<bool>;
+    { Policies::FillModel::samplesFillRates } -> std::convertible_to<bool>;
+};
+
+/**
+ * @brief Every feature, as configured by RunParams. The default of every run.
+ */
+using FullRealism = EnginePolicies<ExchangeHours, MarginAccount, NextDaySettlement,
+    SampledFillRates>;
+
+/**
+ * @brief Only what is needed to replay quotes and match orders against them
+ * @details For sweeps over signal parameters, where calendar, margin, settlement and fill
+ * uncertainty are not what is being measured. Ignores enforceTradingHours, interestRate and the
+ * fill-rate distributions of RunParams; leverageFactor still limits the orders a strategy can
+ * place.
+ */
+using RawThroughput = EnginePolicies<AlwaysOpen, CashAccount, NoSettlement, CompleteFills>;
+
+}  // namespace sim
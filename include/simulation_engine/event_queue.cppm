@@ -0,0 +1,97 @@
+// event_queue.cppm
+export module simulation_engine:event_queue;
+
+import :order_placement;
+import :snapshot;
+import :types;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief An order reaching the exchange after the send latency
+ * @details The order itself stays in the engine's in-flight store until it arrives, so cancels
+ * and replaces sent while it is in flight still apply to it.
+ */
+struct OrderArrival {
+    OrderId orderId;
+};
+
+/**
+ * @brief Latency-delayed action waiting in the event queue
+ * @details The alternatives are listed in the order actions due at the same time are applied:
+ * cancels, then replaces, then order arrivals, then fill notifications. A cancel sent on the
+ * same quote as its order therefore removes it before it can trade. The engine keeps fill
+ * notifications in a queue of their own, delivered only after each quote is matched.
+ */
+using ScheduledAction = std::variant<CancelOrder, ReplaceOrder, OrderArrival, PendingNotification>;
+
+struct ScheduledEvent {
+    TimeStamp time;            // When the action becomes due
+    std::uint64_t sequence;    // Scheduling order, breaks ties between actions of the same kind
+    ScheduledAction action;
+};
+
+/**
+ * @brief Min-heap of latency-delayed actions ordered by activation time
+ * @details
+ * Events come out ordered by time, then by the kind priority of ScheduledAction, then in the
+ * order they were scheduled. Popping the events due on a quote costs O(log n) each, so a quote
+ * with nothing due costs nothing regardless of how many actions are outstanding.
+ */
+class EventQueue {
+   public:
+    void push(TimeStamp time, ScheduledAction action) {
+        events_.push_back({time, nextSequence_++, std::move(action)});
+        std::push_heap(events_.begin(), events_.end(), later);
+    }
+
+    /**
+     * @return True if the earliest event is due at currentTime.
+     */
+    bool due(TimeStamp currentTime) const {
+        return !events_.empty() && events_.front().time <= currentTime;
+    }
+
+    /**
+     * @brief Remove and return the earliest event; the queue must not be empty.
+     */
+    ScheduledEvent pop() {
+        std::pop_heap(events_.begin(), events_.end(), later);
+        ScheduledEvent event = std::move(events_.back());
+        events_.pop_back();
+        return event;
+    }
+
+    std::size_t size() const { return events_.size(); }
+    bool empty() const { return events_.empty(); }
+    void clear() { events_.clear(); }
+
+    /**
+     * @brief Write the queue to a snapshot, heap order and sequence numbers included.
+     */
+    void save(SnapshotWriter& out) const {
+        out.write(events_);
+        out.write(nextSequence_);
+    }
+
+    /**
+     * @brief Replace the queue with one written by save.
+     * @return False if the snapshot is truncated.
+     */
+    bool load(SnapshotReader& in) { return in.read(events_) && in.read(nextSequence_); }
+
+   private:
+    // Heap comparator: a sorts after b, which puts the earliest event at the front
+    static bool later(const ScheduledEvent& a, const ScheduledEvent& b) {
+        if (a.time != b.time) return b.time < a.time;
+        if (a.action.index() != b.action.index()) return b.action.index() < a.action.index();
+        return b.sequence < a.sequence;
+    }
+
+    std::vector<ScheduledEvent> events_;
+    std::uint64_t nextSequence_{0};
+};
+
+}  // namespace sim
@@ -0,0 +1,90 @@
+// ingest.cppm
+export module simulation_engine:ingest;
+
+import :run_params;
+
+import std;
+
+export namespace sim {
+
+enum class IngestFormat : std::uint8_t {
+    Parquet = 0,                // Indexed Parquet, the layout MarketDataParquet reads
+    ParquetWithQuoteCache = 1,  // Indexed Parquet plus its MarketDataQuoteCache file
+};
+
+/**
+ * @brief Settings for turning raw MBP-10 day files into the engine's indexed layout
+ */
+struct IngestParams {
+    // Symbols to keep; the symbol at position i is written with symbol_id i
+    std::vector<std::string> symbols{};
+
+    // Raw prices are in dollars; the engine reads them as integers scaled by this factor
+    std::int64_t priceScale{10'000};
+
+    std::string outputDirectory{};
+    std::string outputPrefix{"indexed_"};  // Output file name is prefix + input file name
+    IngestFormat format{IngestFormat::Parquet};
+
+    std::size_t threads{1};  // Days ingested concurrently (0 uses every hardware thread)
+    bool overwrite{false};   // Re-ingest days whose output already exists
+
+    // Cache directory and symbol filter used when priming quote caches
+    MarketDataParams marketData{};
+};
+
+/**
+ * @brief Outcome of ingesting one raw day file
+ */
+struct IngestDayReport {
+    std::string inputPath;
+    std::string outputPath;
+    std::int64_t rowsRead{0};
+    std::int64_t rowsWritten{0};
+    std::chrono::nanoseconds elapsed{0};
+    bool skipped{false};    // Output already existed and overwrite was off
+    bool cacheOnly{false};  // Output already existed but its quote cache did not, so only the
+                            // cache was written
+    bool succeeded{false};
+    std::string error{};
+};
+
+/**
+ * @brief Path the indexed output of a raw day file is written to.
+ */
+std::string ingestOutputPath(const std::string& inputPath, const IngestParams& params);
+
+/**
+ * @brief Convert one raw day file into the indexed layout.
+ * @details
+ * Keeps the rows of the configured symbols, scales price and bid/ask price columns to unsigned
+ * integers, appends a UINT16 symbol_id column and sorts by (ts_event, symbol_id), matching the
+ * output of the duckdb preprocessing scripts. The output is written to a temporary file and
+ * renamed into place, so an interrupted run never leaves a partial day behind and can simply be
+ * restarted. With IngestFormat::ParquetWithQuoteCache a day only counts as done once its quote
+ * cache is valid too; a restart primes the missing cache of an existing output.
+ * @param inputPath Path to the raw Parquet day file.
+ * @param params Ingest settings.
+ * @return Row counts and timing, or the error that stopped the day.
+ */
+IngestDayReport ingestDay(const std::string& inputPath, const IngestParams& params);
+
+/**
+ * @brief Ingest many raw day files, several at a time.
+ * @details Days whose output already exists are skipped unless IngestParams::overwrite is set.
+ * @return One report per input, in input order.
+ */
+std::vector<IngestDayReport> ingestDays(const std::vector<std::string>& inputPaths,
+    const IngestParams& params);
+
+/**
+ * @brief Print per-day row counts and throughput.
+ * @param reports Reports returned by ingestDays.
+ * @param wallTime Time the whole ingest took, for the aggregate throughput.
+ * @param out The output stream for the report.
+ */
+void outputIngestReport(const std::vector<IngestDayReport>& reports,
+    std::chrono::nanoseconds wallTime,
+    std::ostream& out);
+
+}  // namespace sim
@@ -0,0 +1,146 @@
+// keyframe_index.cppm
+export module simulation_engine:keyframe_index;
+
+import :quote;
+import :types;
+import :market_state;
+import :run_params;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief Snapshot of the market state at one point of a file's quote stream
+ * @details Only the books of symbols quoted in the file before quoteOffset are part of the
+ * snapshot; the others still hold whatever the previous files left in the market state.
+ */
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+struct Keyframe {
+    std::uint64_t quoteOffset{0};  // Position of the first quote not yet applied
+    TimeStamp timestamp{0};        // Timestamp of that quote
+    std::array<bool, numberOfSymbols> updated{};
+    MarketState<depth, numberOfSymbols> state{};
+};
+
+/**
+ * @brief Periodic keyframes of one market data file
+ * @details
+ * Built by feeding the file's quotes in order to observe(). A keyframe is taken every
+ * intervalNanoseconds of market time or every intervalQuotes quotes, whichever comes first
+ * (0 disables either), and always at the first quote. Keyframes are only placed where the
+ * timestamp advances, so every quote before a keyframe is strictly earlier than it. finish()
+ * appends a final keyframe holding the state at the end of the file.
+ */
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+class KeyframeIndex {
+   public:
+    using KeyframeType = Keyframe<depth, numberOfSymbols>;
+
+    KeyframeIndex(std::uint64_t intervalQuotes, std::uint64_t intervalNanoseconds)
+        : intervalQuotes_(intervalQuotes), intervalNanoseconds_(intervalNanoseconds) {}
+
+    /**
+     * @brief Apply the next quote of the file, taking a keyframe before it when one is due.
+     */
+    void observe(const Quote<depth>& quote);
+
+    /**
+     * @brief Append the end-of-file keyframe; call once after the last quote.
+     */
+    void finish();
+
+    /**
+     * @brief Replace the index with keyframes read back from disk.
+     */
+    void assign(std::vector<KeyframeType> keyframes) { keyframes_ = std::move(keyframes); }
+
+    /**
+     * @brief The last keyframe strictly before target, or the first keyframe if there is none.
+     */
+    const KeyframeType& nearest(TimeStamp target) const;
+
+    const KeyframeType& back() const { return keyframes_.back(); }
+    std::span<const KeyframeType> keyframes() const { return keyframes_; }
+
+    /**
+     * @brief Timestamp of the last quote of the file.
+     */
+    TimeStamp lastTimestamp() const { return keyframes_.back().state.timestamp; }
+
+    std::uint64_t intervalQuotes() const { return intervalQuotes_; }
+    std::uint64_t intervalNanoseconds() const { return intervalNanoseconds_; }
+
+   private:
+    bool keyframeDue(const Quote<depth>& quote) const;
+
+    std::uint64_t intervalQuotes_;
+    std::uint64_t intervalNanoseconds_;
+    std::vector<KeyframeType> keyframes_;
+    KeyframeType running_;  // State after every quote observed so far
+};
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+inline bool KeyframeIndex<depth, numberOfSymbols>::keyframeDue(const Quote<depth>& quote) const {
+    if (keyframes_.empty()) return true;
+
+    // Quotes sharing a timestamp stay on the same side of every keyframe
+    if (!(running_.state.timestamp < quote.timestamp)) return false;
+
+    const KeyframeType& last = keyframes_.back();
+    const bool quotesElapsed =
+        intervalQuotes_ != 0 && running_.quoteOffset - last.quoteOffset >= intervalQuotes_;
+    const bool timeElapsed = intervalNanoseconds_ != 0 &&
+        quote.timestamp.value() - last.timestamp.value() >= intervalNanoseconds_;
+    return quotesElapsed || timeElapsed;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+inline void KeyframeIndex<depth, numberOfSymbols>::observe(const Quote<depth>& quote) {
+    if (keyframeDue(quote)) {
+        KeyframeType& keyframe = keyframes_.emplace_back(running_);
+        keyframe.timestamp = quote.timestamp;
+    }
+
+    running_.state.setQuote(static_cast<std::uint16_t>(quote.symbolId), quote);
+    running_.state.timestamp = quote.timestamp;
+    running_.updated[quote.symbolId] = true;
+    ++running_.quoteOffset;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+inline void KeyframeIndex<depth, numberOfSymbols>::finish() {
+    KeyframeType& keyframe = keyframes_.emplace_back(running_);
+    keyframe.timestamp = TimeStamp{running_.state.timestamp.value() + 1};
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+inline const typename KeyframeIndex<depth, numberOfSymbols>::KeyframeType&
+KeyframeIndex<depth, numberOfSymbols>::nearest(TimeStamp target) const {
+    auto after = std::partition_point(keyframes_.begin(), keyframes_.end(),
+        [target](const KeyframeType& keyframe) { return keyframe.timestamp < target; });
+    return (after == keyframes_.begin()) ? keyframes_.front() : *std::prev(after);
+}
+
+/**
+ * @brief Persist the keyframe index of a source file next to its quote cache.
+ * @details The file is keyed like the quote cache, plus the keyframe intervals, and is written
+ * to a temporary file and renamed into place.
+ * @return False if the index could not be written.
+ */
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool saveKeyframeIndex(const std::string& sourcePath,
+    const MarketDataParams& params,
+    const KeyframeIndex<depth, numberOfSymbols>& index);
+
+/**
+ * @brief Read back a persisted keyframe index.
+ * @return False if there is none, or it was built from a different source file, symbol filter
+ * or keyframe interval.
+ */
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool loadKeyframeIndex(const std::string& sourcePath,
+    const MarketDataParams& params,
+    KeyframeIndex<depth, numberOfSymbols>& index);
+
+}  // namespace sim
@@ -2,8 +2,12 @@
 export module simulation_engine:market_data;
 
 import :quote;
+import :quote_store;
 import :types;
 import :market_state;
+import :keyframe_index;
+import :run_params;
+import :snapshot;
 
 import datetime;
 
@@ -11,18 +15,175 @@ import std;
 
 export namespace sim {
 
+/**
+ * @brief Timing of one market data file load
+ * @details The stall time is how long the simulation loop was blocked waiting for the file. When
+ * background prefetching keeps up it is close to zero even though the decode time is not.
+ */
+struct FileLoadReport {
+    std::string filePath;
+    std::size_t quotesLoaded{0};
+    std::chrono::nanoseconds decodeTime{0};
+    std::chrono::nanoseconds stallTime{0};
+    bool prefetched{false};
+    bool failed{false};  // The file could not be opened or decoded completely
+};
+
+/**
+ * @brief Background decoder for upcoming market data files
+ * @details
+ * A small pool of worker threads decodes scheduled files into their own quote buffers, held in
+ * the caller's layout so a file waiting to be consumed takes no more memory than it will once
+ * it is. take() hands a finished buffer to the caller by swapping it with the caller's buffer,
+ * and keeps the swapped-out buffer for reuse by a later job, so neither side copies quotes.
+ */
+template <std::size_t depth>
+class QuotePrefetcher {
+   public:
+    using Decoder = std::function<bool(const std::string&, QuoteBuffer<depth>&)>;
+
+    QuotePrefetcher(std::size_t numberOfThreads, QuoteLayout layout, Decoder decoder)
+        : decoder_(std::move(decoder)), layout_(layout) {
+        for (std::size_t i = 0; i < std::max<std::size_t>(numberOfThreads, 1); ++i) {
+            workers_.emplace_back([this](std::stop_token stopToken) { work(stopToken); });
+        }
+    }
+
+    ~QuotePrefetcher() {
+        for (auto& worker : workers_) {
+            worker.request_stop();
+        }
+        jobAvailable_.notify_all();
+    }
+
+    QuotePrefetcher(const QuotePrefetcher&) = delete;
+    QuotePrefetcher& operator=(const QuotePrefetcher&) = delete;
+
+    bool isScheduled(std::size_t fileIndex) {
+        std::scoped_lock lock(mutex_);
+        return jobs_.contains(fileIndex);
+    }
+
+    /**
+     * @brief Queue a file for background decoding.
+     */
+    void schedule(std::size_t fileIndex, const std::string& filePath) {
+        {
+            std::scoped_lock lock(mutex_);
+            if (jobs_.contains(fileIndex)) return;
+
+            auto job = std::make_unique<Job>();
+            job->filePath = filePath;
+            if (spareBuffers_.empty()) {
+                job->quotes = QuoteBuffer<depth>(layout_);
+            } else {
+                job->quotes = std::move(spareBuffers_.back());
+                spareBuffers_.pop_back();
+            }
+            jobs_.emplace(fileIndex, std::move(job));
+            queue_.push_back(fileIndex);
+        }
+        jobAvailable_.notify_one();
+    }
+
+    /**
+     * @brief Wait for a scheduled file and swap its quotes into the caller's buffer.
+     * @param fileIndex The file to take. It must have been scheduled.
+     * @param out Receives the decoded quotes; its previous contents are recycled.
+     * @param report Receives the decode and stall times.
+     * @return The decoder's result for the file.
+     */
+    bool take(std::size_t fileIndex, QuoteBuffer<depth>& out, FileLoadReport& report) {
+        const auto waitStart = std::chrono::steady_clock::now();
+
+        std::unique_lock lock(mutex_);
+        auto it = jobs_.find(fileIndex);
+        if (it == jobs_.end()) return false;
+
+        Job& job = *it->second;
+        jobDone_.wait(lock, [&job] { return job.done; });
+
+        report.stallTime = std::chrono::steady_clock::now() - waitStart;
+        report.decodeTime = job.decodeTime;
+        report.prefetched = true;
+
+        const bool succeeded = job.succeeded;
+        std::swap(out, job.quotes);
+        job.quotes.clear();
+        spareBuffers_.push_back(std::move(job.quotes));
+        jobs_.erase(it);
+        return succeeded;
+    }
+
+   private:
+    struct Job {
+        std::string filePath;
+        QuoteBuffer<depth> quotes;
+        std::chrono::nanoseconds decodeTime{0};
+        bool succeeded{false};
+        bool done{false};
+    };
+
+    void work(std::stop_token stopToken) {
+        while (true) {
+            Job* job = nullptr;
+            {
+                std::unique_lock lock(mutex_);
+                if (!jobAvailable_.wait(lock, stopToken, [this] { return !queue_.empty(); })) {
+                    return;
+                }
+                job = jobs_.at(queue_.front()).get();
+                queue_.pop_front();
+            }
+
+            // Jobs are only erased by take() once done, so the pointer stays valid while decoding
+            const auto decodeStart = std::chrono::steady_clock::now();
+            const bool succeeded = decoder_(job->filePath, job->quotes);
+            const auto decodeTime = std::chrono::steady_clock::now() - decodeStart;
+
+            {
+                std::scoped_lock lock(mutex_);
+                job->decodeTime = decodeTime;
+                job->succeeded = succeeded;
+                job->done = true;
+            }
+            jobDone_.notify_all();
+        }
+    }
+
+    Decoder decoder_;
+    QuoteLayout layout_;
+    std::mutex mutex_;
+    std::condition_variable_any jobAvailable_;
+    std::condition_variable_any jobDone_;
+    std::map<std::size_t, std::unique_ptr<Job>> jobs_;
+    std::deque<std::size_t> queue_;
+    std::vector<QuoteBuffer<depth>> spareBuffers_;
+
+    // Declared last so the workers are joined before the state they use is destroyed
+    std::vector<std::jthread> workers_;
+};
+
 template <std::size_t depth, std::uint16_t numberOfSymbols>
 class IMarketData {
    public:
-    IMarketData(const std::string& marketDataFilePath, bool multipleFiles)
+    IMarketData(const std::string& marketDataFilePath,
+        bool multipleFiles,
+        const MarketDataParams& params = {})
         : marketDataFilePath_(marketDataFilePath),
           marketDataFilePaths_{},
+          params_(params),
+          quotes_(params.layout),
           multipleFiles_(multipleFiles),
           currentFileIndex(0) {}
 
-    IMarketData(const std::vector<std::string>& marketDataFilePaths, bool multipleFiles)
+    IMarketData(const std::vector<std::string>& marketDataFilePaths,
+        bool multipleFiles,
+        const MarketDataParams& params = {})
         : marketDataFilePath_{},
           marketDataFilePaths_(marketDataFilePaths),
+          params_(params),
+          quotes_(params.layout),
           multipleFiles_(multipleFiles),
           currentFileIndex(0) {}
 
@@ -30,34 +191,157 @@ class IMarketData {
 
     const MarketState<depth, numberOfSymbols>& currentMarketState() const { return marketState_; }
 
+    /**
+     * @brief Symbol whose quote the last nextMarketState() call applied.
+     */
+    std::uint16_t lastUpdatedSymbol() const { return lastUpdatedSymbol_; }
+
     bool nextMarketState() {
-        // Use a while loop to skip empty files without using the stack
-        while (currentQuoteIndex_ >= quotes_.size()) {
-            if (!multipleFiles_ || (currentFileIndex + 1) >= marketDataFilePaths_.size()) {
-                return false;
+        if (!bufferNextQuote()) return false;
+
+        applyBufferedQuote(currentQuoteIndex_++);
+        return true;
+    }
+
+    /**
+     * @brief Apply the next quote only if it is timestamped before stopTime.
+     * @return False if the market data is exhausted or the next quote is at or after stopTime,
+     * in which case it stays next.
+     */
+    bool nextMarketState(TimeStamp stopTime) {
+        if (!bufferNextQuote() || !(bufferedTimestamp(currentQuoteIndex_) < stopTime)) {
+            return false;
+        }
+
+        applyBufferedQuote(currentQuoteIndex_++);
+        return true;
+    }
+
+    /**
+     * @return True if nextMarketState() has another quote to apply.
+     */
+    bool hasNextMarketState() { return bufferNextQuote(); }
+
+    /**
+     * @brief Whether a file failed to open or decode.
+     * @details The stream ends at the failure instead of moving on to the next file, so a
+     * corrupt or truncated file is never mistaken for a short one.
+     */
+    bool loadFailed() const { return !loadError_.empty(); }
+
+    /**
+     * @brief What failed to load, or empty if nothing did.
+     */
+    const std::string& loadError() const { return loadError_; }
+
+    /**
+     * @brief Write the position in the stream and the market state there to a snapshot.
+     */
+    void saveCursor(SnapshotWriter& out) const {
+        out.write(static_cast<std::uint64_t>(currentFileIndex));
+        out.write(streamPosition());
+        out.write(marketState_);
+        out.write(lastUpdatedSymbol_);
+    }
+
+    /**
+     * @brief Move to a position written by saveCursor and restore the market state there.
+     * @details The source must be over the same files as the one that was saved. Only the file
+     * holding the position is loaded, so restoring costs no replay of the quotes before it.
+     * @return False if the snapshot is truncated or names a file this source does not have.
+     */
+    bool restoreCursor(SnapshotReader& in) {
+        std::uint64_t fileIndex = 0;
+        std::uint64_t position = 0;
+        MarketState<depth, numberOfSymbols> marketState;
+        std::uint16_t lastUpdatedSymbol = 0;
+        if (!in.read(fileIndex) || !in.read(position) || !in.read(marketState) ||
+            !in.read(lastUpdatedSymbol)) {
+            return false;
+        }
+
+        if (multipleFiles_) {
+            if (fileIndex >= marketDataFilePaths_.size()) return false;
+            if (fileIndex != currentFileIndex) {
+                currentFileIndex = static_cast<std::size_t>(fileIndex);
+                if (!loadFile(currentFileIndex)) return false;
+                fileQuoteOffset_ = 0;
+                currentQuoteIndex_ = 0;
             }
+        } else if (fileIndex != 0) {
+            return false;
+        }
 
-            currentFileIndex++;
-            loadData(currentFileIndex);
+        positionAt(position);
+        marketState_ = marketState;
+        lastUpdatedSymbol_ = lastUpdatedSymbol;
+        return true;
+    }
+
+    /**
+     * @brief Move the stream to a point in time without delivering the quotes before it.
+     * @details
+     * Afterwards currentMarketState() reflects every quote timestamped before target and
+     * nextMarketState() delivers the first quote at or after it. Whole files that end before
+     * target are skipped by applying their final keyframe; inside the target file the nearest
+     * keyframe is restored and only the quotes between it and target are replayed.
+     *
+     * A file's keyframe index is built the first time a seek lands in it and, with
+     * MarketDataParams::persistKeyframes, saved next to its quote cache so later runs load it
+     * instead. Seeking backwards restarts from the first file. Quotes must be time ordered
+     * within and across files. Call this before a run, since the engine does not see the
+     * skipped quotes.
+     * @param target The time to move to.
+     * @return False if the market data ends before target.
+     */
+    bool seek(TimeStamp target) {
+        if (target < marketState_.timestamp && !restart()) return false;
+
+        // Skip whole files that end before target, carrying their final books forward
+        while (multipleFiles_ && (currentFileIndex + 1) < marketDataFilePaths_.size()) {
+            const KeyframeIndex<depth, numberOfSymbols>& index = keyframeIndex();
+            if (!(index.lastTimestamp() < target)) break;
+            applyKeyframe(index.back());
+
+            // Later files with an index on disk are skipped without being decoded at all
+            std::size_t nextFile = currentFileIndex + 1;
+            while (nextFile + 1 < marketDataFilePaths_.size()) {
+                const KeyframeIndex<depth, numberOfSymbols>* stored =
+                    storedKeyframeIndex(nextFile);
+                if (stored == nullptr || !(stored->lastTimestamp() < target)) break;
+                applyKeyframe(stored->back());
+                nextFile++;
+            }
+
+            currentFileIndex = nextFile;
+            loadFile(currentFileIndex);
+            fileQuoteOffset_ = 0;
             currentQuoteIndex_ = 0;
+        }
 
-            // Loop continues if loadQuotes resulted in an empty quotes_ vector
+        const Keyframe<depth, numberOfSymbols>& keyframe = keyframeIndex().nearest(target);
+        if (keyframe.quoteOffset > streamPosition()) {
+            positionAt(keyframe.quoteOffset);
+            applyKeyframe(keyframe);
         }
 
-        const Quote<depth>& nextQuote = quotes_[currentQuoteIndex_++];
-        std::uint16_t symbolWithNextUpdate = nextQuote.symbolId;
-        marketState_[symbolWithNextUpdate] = nextQuote;
-        marketState_.timestamp = nextQuote.timestamp;  // Update timestamp from current quote
-        return true;
+        // Replay only the gap between the keyframe and target
+        while (bufferNextQuote()) {
+            if (!(bufferedTimestamp(currentQuoteIndex_) < target)) return true;
+            applyBufferedQuote(currentQuoteIndex_++);
+        }
+        return false;
     }
 
-    const Quote<depth>& getQuote(std::uint16_t symbol) { return marketState_.getQuote(symbol); }
+    const Quote<depth>& getQuote(std::uint16_t symbol) const {
+        return marketState_.getQuote(symbol);
+    }
 
     std::size_t getCurrentIndex() const { return currentQuoteIndex_; }
 
-    const std::array<Ticks, numberOfSymbols> bestBids() { return marketState_.getBestBids(); }
+    std::span<const Ticks, numberOfSymbols> bestBids() const { return marketState_.bestBids(); }
 
-    const std::array<Ticks, numberOfSymbols> bestAsks() { return marketState_.getBestAsks(); }
+    std::span<const Ticks, numberOfSymbols> bestAsks() const { return marketState_.bestAsks(); }
 
     Ticks bestBid(std::uint16_t symbolId) { return marketState_.bestBid(symbolId); }
 
@@ -71,11 +355,19 @@ class IMarketData {
         return marketState_.getBid(level, symbolId);
     }
 
-    const std::array<Ticks, depth> bestBidSizes(std::uint16_t symbolId) {
+    std::span<const Ticks, depth> getBids(std::uint16_t symbolId) const {
+        return marketState_.getBids(symbolId);
+    }
+
+    std::span<const Ticks, depth> getAsks(std::uint16_t symbolId) const {
+        return marketState_.getAsks(symbolId);
+    }
+
+    std::span<const Ticks, depth> getBidSizes(std::uint16_t symbolId) const {
         return marketState_.getBidSizes(symbolId);
     }
 
-    const std::array<Ticks, depth> getAskSizes(std::uint16_t symbolId) {
+    std::span<const Ticks, depth> getAskSizes(std::uint16_t symbolId) const {
         return marketState_.getAskSizes(symbolId);
     }
 
@@ -89,40 +381,659 @@ class IMarketData {
 
     TimeStamp currentTimeStamp() { return marketState_.timestamp; }
 
+    /**
+     * @brief Per-file load timings for multi-file runs, in load order.
+     */
+    const std::vector<FileLoadReport>& loadReports() const { return loadReports_; }
+
+    /**
+     * @brief Print per-file decode and stall times, showing whether file I/O was hidden.
+     * @param out The output stream for the report.
+     */
+    void outputLoadReport(std::ostream& out) const {
+        if (loadReports_.empty()) return;
+
+        auto milliseconds = [](std::chrono::nanoseconds duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+
+        out << "\nMarket Data Loading\n-------------------\n";
+        out << std::left << std::setw(12) << "Quotes" << std::setw(14) << "Decode (ms)"
+            << std::setw(14) << "Stall (ms)" << std::setw(12) << "Prefetched" << "File"
+            << std::endl;
+
+        std::chrono::nanoseconds totalDecode{0};
+        std::chrono::nanoseconds totalStall{0};
+        std::size_t totalQuotes = 0;
+        for (const FileLoadReport& report : loadReports_) {
+            out << std::left << std::setw(12) << report.quotesLoaded << std::setw(14)
+                << std::fixed << std::setprecision(1) << milliseconds(report.decodeTime)
+                << std::setw(14) << milliseconds(report.stallTime) << std::setw(12)
+                << (report.prefetched ? "yes" : "no") << report.filePath
+                << (report.failed ? " (failed)" : "") << std::endl;
+            totalDecode += report.decodeTime;
+            totalStall += report.stallTime;
+            totalQuotes += report.quotesLoaded;
+        }
+        out << "Total decode: " << milliseconds(totalDecode)
+            << " ms, total stall: " << milliseconds(totalStall) << " ms";
+        if (totalDecode.count() > 0) {
+            const double seconds = std::chrono::duration<double>(totalDecode).count();
+            out << ", " << std::setprecision(0) << totalQuotes / seconds << " quotes/s";
+        }
+        out << std::endl;
+    }
+
    protected:
-    bool loadData(std::size_t fileIndex) {
-        return loadData(marketDataFilePaths_[currentFileIndex]);
+    using QuoteFileDecoder = typename QuotePrefetcher<depth>::Decoder;
+
+    /**
+     * @brief Make sure the buffer holds the next quote, refilling it from the current file or
+     * moving on to the next one.
+     * @return False once the market data is exhausted.
+     */
+    bool bufferNextQuote() {
+        // Use a while loop to skip empty files without using the stack
+        while (currentQuoteIndex_ >= bufferedQuotes_) {
+            // Nothing after a file that failed to load is delivered
+            if (loadFailed()) return false;
+
+            // Streaming sources refill the buffer from the current file before moving on
+            if (loadNextBatch()) {
+                fileQuoteOffset_ += bufferedQuotes_;
+                refreshQuoteView();
+                currentQuoteIndex_ = 0;
+                continue;
+            }
+            if (loadFailed()) return false;
+
+            if (!multipleFiles_ || (currentFileIndex + 1) >= marketDataFilePaths_.size()) {
+                return false;
+            }
+
+            currentFileIndex++;
+            loadFile(currentFileIndex);
+            fileQuoteOffset_ = 0;
+            currentQuoteIndex_ = 0;
+
+            // Loop continues if loadQuotes resulted in an empty quote buffer
+        }
+        return true;
+    }
+
+    /**
+     * @brief Apply buffered quote index to the market state.
+     */
+    void applyBufferedQuote(std::size_t index) {
+        switch (params_.layout) {
+            case QuoteLayout::Columns: {
+                const ColumnarQuotes<depth>& columns = quotes_.columns();
+                std::uint16_t symbolWithNextUpdate = columns.symbolIds[index];
+                columns.load(index, marketState_[symbolWithNextUpdate]);
+                marketState_.refreshTopOfBook(symbolWithNextUpdate);
+                marketState_.timestamp = columns.timestamps[index];
+                lastUpdatedSymbol_ = symbolWithNextUpdate;
+                return;
+            }
+            case QuoteLayout::Compact: {
+                const CompactQuotes<depth>& compact = quotes_.compact();
+                std::uint16_t symbolWithNextUpdate = compact.symbolId(index);
+                compact.load(index, marketState_[symbolWithNextUpdate]);
+                marketState_.refreshTopOfBook(symbolWithNextUpdate);
+                marketState_.timestamp = marketState_[symbolWithNextUpdate].timestamp;
+                lastUpdatedSymbol_ = symbolWithNextUpdate;
+                return;
+            }
+            case QuoteLayout::Rows:
+                break;
+        }
+
+        const Quote<depth>& nextQuote = quoteView_[index];
+        std::uint16_t symbolWithNextUpdate = nextQuote.symbolId;
+        marketState_.setQuote(symbolWithNextUpdate, nextQuote);
+        marketState_.timestamp = nextQuote.timestamp;  // Update timestamp from current quote
+        lastUpdatedSymbol_ = symbolWithNextUpdate;
+    }
+
+    void loadBufferedQuote(std::size_t index, Quote<depth>& out) const {
+        switch (params_.layout) {
+            case QuoteLayout::Columns:
+                quotes_.columns().load(index, out);
+                return;
+            case QuoteLayout::Compact:
+                quotes_.compact().load(index, out);
+                return;
+            case QuoteLayout::Rows:
+                out = quoteView_[index];
+                return;
+        }
+    }
+
+    TimeStamp bufferedTimestamp(std::size_t index) const {
+        switch (params_.layout) {
+            case QuoteLayout::Columns:
+                return quotes_.columns().timestamps[index];
+            case QuoteLayout::Compact:
+                return quotes_.compact().timestamp(index);
+            case QuoteLayout::Rows:
+                break;
+        }
+        return quoteView_[index].timestamp;
+    }
+
+    const std::string& currentFilePath() const {
+        return multipleFiles_ ? marketDataFilePaths_[currentFileIndex] : marketDataFilePath_;
+    }
+
+    /**
+     * @brief Position of the next quote within the current file's quote stream.
+     */
+    std::uint64_t streamPosition() const { return fileQuoteOffset_ + currentQuoteIndex_; }
+
+    /**
+     * @brief Go back to the first quote of the current file.
+     */
+    bool rewindFile() {
+        bool rewound = true;
+        if (streamsBatches()) {
+            rewound = restartFile();
+            refreshQuoteView();
+        }
+        fileQuoteOffset_ = 0;
+        currentQuoteIndex_ = 0;
+        return rewound;
+    }
+
+    /**
+     * @brief Make quote offset of the current file the next quote, without applying any quote.
+     * @details Streaming sources decode the batches in between but skip their quotes.
+     */
+    void positionAt(std::uint64_t offset) {
+        if (offset < fileQuoteOffset_) rewindFile();
+
+        while (offset >= fileQuoteOffset_ + bufferedQuotes_ && loadNextBatch()) {
+            fileQuoteOffset_ += bufferedQuotes_;
+            refreshQuoteView();
+        }
+        currentQuoteIndex_ = static_cast<std::size_t>(
+            std::min<std::uint64_t>(offset - fileQuoteOffset_, bufferedQuotes_));
+    }
+
+    /**
+     * @brief Start over from the first quote of the first file with an empty market state.
+     */
+    bool restart() {
+        marketState_ = {};
+        if (multipleFiles_) {
+            currentFileIndex = 0;
+            const bool loaded = loadFile(0);
+            fileQuoteOffset_ = 0;
+            currentQuoteIndex_ = 0;
+            return loaded;
+        }
+        return rewindFile();
+    }
+
+    void applyKeyframe(const Keyframe<depth, numberOfSymbols>& keyframe) {
+        for (std::uint16_t symbol = 0; symbol < numberOfSymbols; ++symbol) {
+            if (keyframe.updated[symbol]) {
+                marketState_.setQuote(symbol, keyframe.state[symbol]);
+            }
+        }
+        if (keyframe.state.timestamp.value() != 0) {
+            marketState_.timestamp = keyframe.state.timestamp;
+        }
+    }
+
+    /**
+     * @brief Keyframe index of the current file, loading or building it on first use.
+     */
+    const KeyframeIndex<depth, numberOfSymbols>& keyframeIndex() {
+        if (const auto* stored = storedKeyframeIndex(currentFileIndex)) return *stored;
+
+        auto index = std::make_unique<KeyframeIndex<depth, numberOfSymbols>>(
+            params_.keyframeIntervalQuotes, params_.keyframeIntervalNanoseconds);
+        buildKeyframeIndex(*index);
+
+        const std::string& sourcePath = currentFilePath();
+        if (params_.persistKeyframes && !sourcePath.empty()) {
+            saveKeyframeIndex(sourcePath, params_, *index);
+        }
+
+        keyframeIndexes_[currentFileIndex] = std::move(index);
+        return *keyframeIndexes_[currentFileIndex];
+    }
+
+    /**
+     * @brief Keyframe index of a file if it is in memory or persisted, without decoding the file.
+     * @return Null if the index would have to be built.
+     */
+    const KeyframeIndex<depth, numberOfSymbols>* storedKeyframeIndex(std::size_t fileIndex) {
+        if (keyframeIndexes_.size() <= fileIndex) keyframeIndexes_.resize(fileIndex + 1);
+        if (keyframeIndexes_[fileIndex]) return keyframeIndexes_[fileIndex].get();
+
+        const std::string& sourcePath =
+            multipleFiles_ ? marketDataFilePaths_[fileIndex] : marketDataFilePath_;
+        if (!params_.persistKeyframes || sourcePath.empty()) return nullptr;
+
+        auto index = std::make_unique<KeyframeIndex<depth, numberOfSymbols>>(
+            params_.keyframeIntervalQuotes, params_.keyframeIntervalNanoseconds);
+        if (!loadKeyframeIndex(sourcePath, params_, *index)) return nullptr;
+
+        keyframeIndexes_[fileIndex] = std::move(index);
+        return keyframeIndexes_[fileIndex].get();
+    }
+
+    /**
+     * @brief Feed every quote of the current file to index, leaving the stream where it was.
+     */
+    void buildKeyframeIndex(KeyframeIndex<depth, numberOfSymbols>& index) {
+        const std::uint64_t position = streamPosition();
+        if (streamsBatches()) rewindFile();
+
+        Quote<depth> quote{};
+        while (true) {
+            for (std::size_t i = 0; i < bufferedQuotes_; ++i) {
+                loadBufferedQuote(i, quote);
+                index.observe(quote);
+            }
+            if (!streamsBatches() || !loadNextBatch()) break;
+            fileQuoteOffset_ += bufferedQuotes_;
+            refreshQuoteView();
+        }
+        index.finish();
+
+        if (streamsBatches()) positionAt(position);
+    }
+
+    /**
+     * @brief Load one of the files of a multi-file run into the quote buffer.
+     * @details Takes the file from the prefetcher when it was decoded in the background, then
+     * schedules the files after it so they decode while this one is consumed.
+     * @param fileIndex Index into marketDataFilePaths_.
+     * @return True if the file was loaded.
+     */
+    bool loadFile(std::size_t fileIndex) {
+        FileLoadReport report;
+        report.filePath = marketDataFilePaths_[fileIndex];
+
+        bool loaded = false;
+        if (prefetcher_ && prefetcher_->isScheduled(fileIndex)) {
+            loaded = prefetcher_->take(fileIndex, quotes_, report);
+        } else {
+            const auto loadStart = std::chrono::steady_clock::now();
+            loaded = loadData(marketDataFilePaths_[fileIndex]);
+            report.decodeTime = std::chrono::steady_clock::now() - loadStart;
+            report.stallTime = report.decodeTime;
+        }
+
+        refreshQuoteView();
+        report.quotesLoaded = bufferedQuotes_;
+        if (!loaded) {
+            report.failed = true;
+            recordLoadError("Could not load " + report.filePath);
+        }
+        loadReports_.push_back(std::move(report));
+
+        schedulePrefetch(fileIndex);
+        return loaded;
+    }
+
+    /**
+     * @brief Queue the files following fileIndex for background decoding.
+     * @details Does nothing for single-file runs, when prefetching is disabled, or when the
+     * source provides no file decoder.
+     */
+    void schedulePrefetch(std::size_t fileIndex) {
+        if (!multipleFiles_ || params_.prefetchDepth == 0) return;
+
+        if (!prefetcher_) {
+            QuoteFileDecoder decoder = fileDecoder();
+            if (!decoder) return;
+            prefetcher_ = std::make_unique<QuotePrefetcher<depth>>(
+                params_.prefetchThreads, params_.layout, std::move(decoder));
+        }
+
+        const std::size_t lastFile =
+            std::min(fileIndex + params_.prefetchDepth, marketDataFilePaths_.size() - 1);
+        for (std::size_t next = fileIndex + 1; next <= lastFile; ++next) {
+            prefetcher_->schedule(next, marketDataFilePaths_[next]);
+        }
     }
 
     virtual bool loadData() = 0;
     virtual bool loadData(const std::string& marketDataFilePath) = 0;
 
+    /**
+     * @brief Replace the quote buffer with the next batch of the current file.
+     * @details Only streaming sources override this; whole-file sources have nothing left to
+     * read once their buffer is exhausted.
+     * @return True if at least one quote was loaded.
+     */
+    virtual bool loadNextBatch() { return false; }
+
+    /**
+     * @brief A self-contained function that decodes a whole file into a quote buffer.
+     * @details Runs on prefetch threads, so it must not touch the market data object. Sources
+     * that cannot decode files independently return an empty function, which disables prefetch.
+     */
+    virtual QuoteFileDecoder fileDecoder() const { return {}; }
+
+    /**
+     * @brief Whether the buffer holds one batch of the current file rather than all of it.
+     */
+    virtual bool streamsBatches() const { return params_.streaming; }
+
+    /**
+     * @brief Reload the first batch of the current file into the quote buffer.
+     * @details Only called for sources that stream batches.
+     */
+    virtual bool restartFile() { return loadData(currentFilePath()); }
+
+    /**
+     * @brief Quotes of the current file or batch held in memory the source does not own.
+     * @details Sources that serve quotes from such memory, like a memory-mapped cache, override
+     * this so the row layout walks them in place. Null when the quotes are in the owned buffer.
+     */
+    virtual std::optional<std::span<const Quote<depth>>> externalQuotes() const {
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Note that a file failed to load; only the first failure is kept.
+     */
+    void recordLoadError(std::string message) {
+        if (loadError_.empty()) loadError_ = std::move(message);
+    }
+
+    /**
+     * @brief Point the quote view at the quotes just loaded; call after every load.
+     * @details Owned quotes were decoded straight into the selected layout, so only external
+     * quotes served in the columnar or compact layout are encoded here, into the owned buffer.
+     */
+    void refreshQuoteView() {
+        if (const auto external = externalQuotes()) {
+            if (params_.layout == QuoteLayout::Rows) {
+                quoteView_ = *external;
+                bufferedQuotes_ = quoteView_.size();
+                return;
+            }
+            quotes_.assign(*external);
+        }
+        quoteView_ = quotes_.rows();
+        bufferedQuotes_ = quotes_.size();
+    }
+
     const std::string marketDataFilePath_;
     const std::vector<std::string> marketDataFilePaths_;
-    std::vector<Quote<depth>> quotes_;
+    const MarketDataParams params_;
+    QuoteBuffer<depth> quotes_;                // Owned quotes, in the selected layout
+    std::span<const Quote<depth>> quoteView_;  // What nextMarketState() walks in the row layout
+    std::size_t bufferedQuotes_{0};
     std::size_t currentQuoteIndex_{0};
+    std::uint64_t fileQuoteOffset_{0};  // Position of the buffer's first quote within its file
     MarketState<depth, numberOfSymbols> marketState_;
+    std::uint16_t lastUpdatedSymbol_{0};
     bool multipleFiles_;
 
     std::size_t currentFileIndex;
+
+    std::vector<FileLoadReport> loadReports_;
+    std::string loadError_;
+    std::unique_ptr<QuotePrefetcher<depth>> prefetcher_;
+    std::vector<std::unique_ptr<KeyframeIndex<depth, numberOfSymbols>>> keyframeIndexes_;
 };
 
+/**
+ * @brief Outcome of reading one record batch
+ */
+enum class ReadStatus {
+    Batch,      // A batch was decoded, possibly into no quotes
+    EndOfFile,  // Every batch of the file has been read
+    Error,      // The file is corrupt or truncated; the reader is closed
+};
+
+/**
+ * @brief Incremental decoder for a single Parquet quote file
+ * @details
+ * Reads the file one bounded record batch at a time and converts each batch into quotes, so the
+ * decoded Arrow columns for the whole file are never resident at once. The batch size is derived
+ * from MarketDataParams::memoryBudgetBytes.
+ *
+ * Only rtype, symbol_id, ts_event and the bid/ask price and size columns up to depth are read.
+ * Rows whose rtype does not match the depth, whose level-one book is crossed, whose best bid is
+ * not positive, or whose symbol is outside MarketDataParams::symbolIds are removed with vectorized
+ * Arrow compute kernels before any quote is built.
+ */
+template <std::size_t depth>
+class ParquetQuoteReader {
+   public:
+    explicit ParquetQuoteReader(const MarketDataParams& params = {});
+    ~ParquetQuoteReader();
+
+    ParquetQuoteReader(ParquetQuoteReader&& other) noexcept;
+    ParquetQuoteReader& operator=(ParquetQuoteReader&& other) noexcept;
+
+    /**
+     * @brief Open a Parquet file and prepare to read it batch by batch.
+     * @param marketDataFilePath Path to the Parquet file.
+     * @return False if the file cannot be opened or is missing a required column.
+     */
+    bool open(const std::string& marketDataFilePath);
+
+    /**
+     * @brief Open a file that holds the quotes of a single symbol.
+     * @details Every quote is assigned symbolId, so the file does not need a symbol_id column and
+     * MarketDataParams::symbolIds is not applied.
+     * @param marketDataFilePath Path to the Parquet file.
+     * @param symbolId Symbol id given to every quote read from the file.
+     * @return False if the file cannot be opened or is missing a required column.
+     */
+    bool open(const std::string& marketDataFilePath, std::uint16_t symbolId);
+
+    /**
+     * @brief Decode the next record batch and append its quotes to the output buffer.
+     * @details A batch can legitimately contribute no quotes if all of its rows are filtered.
+     * @param out Buffer the decoded quotes are appended to.
+     * @return Batch, EndOfFile once the file is exhausted, or Error if it cannot be decoded, in
+     * which case error() says why.
+     */
+    ReadStatus readNext(std::vector<Quote<depth>>& out);
+
+    /**
+     * @brief Decode the next record batch and append its quotes to a buffer in any layout.
+     * @details The row layout is decoded into directly. The other layouts receive the batch
+     * through a staging buffer that is reused from batch to batch, so at most one batch is ever
+     * held as full-width quotes.
+     */
+    ReadStatus readNext(QuoteBuffer<depth>& out);
+
+    /**
+     * @brief Why the last open or read failed, or empty.
+     */
+    const std::string& error() const { return error_; }
+
+    /**
+     * @brief Total number of rows in the open file, before filtering.
+     */
+    std::int64_t numberOfRows() const;
+
+    /**
+     * @brief Number of rows decoded per batch under the configured memory budget.
+     */
+    std::int64_t batchSize() const;
+
+    void close();
+    bool isOpen() const { return state_ != nullptr; }
+
+   private:
+    struct State;
+
+    bool openFile(const std::string& marketDataFilePath,
+        std::optional<std::uint16_t> symbolIdOverride);
+
+    // Close the reader after a failure and say why
+    ReadStatus fail(std::string message);
+
+    MarketDataParams params_;
+    std::unique_ptr<State> state_;
+    std::vector<Quote<depth>> staging_;  // One batch on its way into a columnar or compact buffer
+    std::string error_;
+};
+
+/**
+ * @brief Decode an entire Parquet quote file into a quote buffer.
+ * @details Drains a ParquetQuoteReader, so at most one record batch of Arrow columns is alive
+ * alongside the output buffer.
+ * @param marketDataFilePath Path to the Parquet file.
+ * @param params Market data parameters controlling the batch size.
+ * @param out Buffer that receives the quotes; it is cleared first.
+ * @return False if the file could not be opened or any batch failed to decode; out then holds
+ * only part of the file.
+ */
+template <std::size_t depth>
+bool readParquetQuotes(const std::string& marketDataFilePath,
+    const MarketDataParams& params,
+    std::vector<Quote<depth>>& out);
+
+/**
+ * @brief Decode an entire Parquet quote file straight into a buffer of any layout.
+ * @details Same as the row overload, but a columnar or compact buffer is filled one batch at a
+ * time, so the file is never held as full-width quotes.
+ */
+template <std::size_t depth>
+bool readParquetQuotes(const std::string& marketDataFilePath,
+    const MarketDataParams& params,
+    QuoteBuffer<depth>& out);
+
 template <std::size_t depth, std::uint16_t numberOfSymbols>
 class MarketDataParquet : public IMarketData<depth, numberOfSymbols> {
    public:
-    MarketDataParquet(const std::string& marketDataFilePath)
-        : IMarketData<depth, numberOfSymbols>(marketDataFilePath, false) {
-        loadData(marketDataFilePath);
+    MarketDataParquet(const std::string& marketDataFilePath, const MarketDataParams& params = {})
+        : IMarketData<depth, numberOfSymbols>(marketDataFilePath, false, params), reader_(params) {
+        if (!loadData(marketDataFilePath)) {
+            this->recordLoadError("Could not load " + marketDataFilePath);
+        }
+        this->refreshQuoteView();
     }
 
-    MarketDataParquet(const std::vector<std::string>& marketDataFilePaths)
-        : IMarketData<depth, numberOfSymbols>(marketDataFilePaths, true) {
-        loadData(marketDataFilePaths[0]);
+    MarketDataParquet(const std::vector<std::string>& marketDataFilePaths,
+        const MarketDataParams& params = {})
+        : IMarketData<depth, numberOfSymbols>(marketDataFilePaths, true, params), reader_(params) {
+        this->loadFile(0);
     }
 
    protected:
+    using typename IMarketData<depth, numberOfSymbols>::QuoteFileDecoder;
+
     bool loadData() override;
     bool loadData(const std::string& marketDataFilePath) override;
+    bool loadNextBatch() override;
+    QuoteFileDecoder fileDecoder() const override;
+
+   private:
+    // Only used in streaming mode, where it stays open between batches
+    ParquetQuoteReader<depth> reader_;
+};
+
+/**
+ * @brief Market data merged on the fly from one Parquet file per symbol
+ * @details
+ * Each day is given as a list of files holding the quotes of one symbol each; the file at
+ * position i supplies symbol i. Every file is streamed through its own ParquetQuoteReader and
+ * the streams are merged with a binary heap on (ts_event, symbol id), which is the order of a
+ * file pre-merged with ORDER BY ts_event, symbol_id. The market state therefore sees the same
+ * update sequence as it would from the pre-merged file, and any universe can be assembled from
+ * per-symbol files without rewriting the dataset.
+ *
+ * Merged quotes are buffered one batch at a time in the layout selected by
+ * MarketDataParams::layout. The memory budget is shared between the per-symbol readers and the
+ * merged batch.
+ *
+ * A day whose files cannot be opened or decoded ends the stream there instead of being skipped;
+ * loadError() names the file.
+ */
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+class MarketDataMerged : public IMarketData<depth, numberOfSymbols> {
+   public:
+    /**
+     * @param symbolFilePaths One file per symbol for a single day, in symbol id order.
+     * @param params Market data parameters.
+     */
+    MarketDataMerged(const std::vector<std::string>& symbolFilePaths,
+        const MarketDataParams& params = {})
+        : MarketDataMerged(std::vector<std::vector<std::string>>{symbolFilePaths}, params) {}
+
+    /**
+     * @param symbolFilePathsPerDay For each day in replay order, one file per symbol in symbol
+     * id order. At most numberOfSymbols files per day.
+     * @param params Market data parameters.
+     */
+    MarketDataMerged(const std::vector<std::vector<std::string>>& symbolFilePathsPerDay,
+        const MarketDataParams& params = {})
+        : IMarketData<depth, numberOfSymbols>(std::string{}, false, params),
+          symbolFilePathsPerDay_(symbolFilePathsPerDay) {
+        loadNextBatch();
+        this->refreshQuoteView();
+    }
+
+   protected:
+    bool loadData() override { return loadNextBatch(); }
+    bool loadData(const std::string&) override { return false; }
+    bool loadNextBatch() override;
+
+    // The merged days form one stream, which restarts from the first day
+    bool streamsBatches() const override { return true; }
+    bool restartFile() override {
+        currentDay_ = 0;
+        dayOpen_ = false;
+        return loadNextBatch();
+    }
+
+   private:
+    // One per-symbol stream and the decoded batch it is currently being merged from
+    struct Source {
+        ParquetQuoteReader<depth> reader;
+        std::vector<Quote<depth>> buffer;
+        std::size_t cursor{0};
+
+        const Quote<depth>& head() const { return buffer[cursor]; }
+
+        // Batch if the buffer holds quotes again; EndOfFile or Error otherwise
+        ReadStatus refill();
+    };
+
+    bool openDay(std::size_t day);
+
+    std::vector<std::vector<std::string>> symbolFilePathsPerDay_;
+    std::size_t currentDay_{0};
+    bool dayOpen_{false};
+    std::size_t batchSize_{0};
+
+    std::vector<Source> sources_;
+    std::vector<std::size_t> heap_;  // Indices of sources with a pending quote
+};
+
+/**
+ * @brief Market data served from quotes that are already in memory
+ * @details Useful for benchmarks and for replaying quotes produced by other tools. The quotes are
+ * taken by value and buffered in the layout selected by MarketDataParams::layout.
+ */
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+class MarketDataInMemory : public IMarketData<depth, numberOfSymbols> {
+   public:
+    MarketDataInMemory(std::vector<Quote<depth>> quotes, const MarketDataParams& params = {})
+        : IMarketData<depth, numberOfSymbols>(std::string{}, false, params) {
+        this->quotes_.assign(std::move(quotes));
+        this->refreshQuoteView();
+    }
+
+   protected:
+    bool loadData() override { return true; }
+    bool loadData(const std::string&) override { return true; }
+
+    // Every quote is already in the buffer
+    bool streamsBatches() const override { return false; }
 };
 
 }  // namespace sim
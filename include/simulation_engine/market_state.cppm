@@ -12,12 +12,36 @@ import std;
 
 export namespace sim {
 
+/**
+ * @brief Latest quote of every symbol
+ * @details
+ * Besides the quotes, the state keeps the top of book of every symbol in contiguous,
+ * cache-line aligned arrays, so valuing a portfolio or checking equity reads four arrays instead
+ * of scanning every quote's levels. Writers must go through setQuote(), or call
+ * refreshTopOfBook() after writing a quote in place through operator[].
+ */
 template <std::size_t depth, std::uint16_t numberOfSymbols>
 struct MarketState {
     // Data storage
     TimeStamp timestamp{0};
     std::array<Quote<depth>, numberOfSymbols> data{};
 
+    // Top of book by symbol id, as returned by Quote::bestBid and Quote::bestAsk
+    alignas(64) std::array<Ticks, numberOfSymbols> topBids{};
+    alignas(64) std::array<Ticks, numberOfSymbols> topAsks{};
+    alignas(64) std::array<Ticks, numberOfSymbols> topBidSizes{};
+    alignas(64) std::array<Ticks, numberOfSymbols> topAskSizes{};
+
+    /**
+     * @brief Replace a symbol's quote and its top of book.
+     */
+    void setQuote(std::uint16_t symbolId, const Quote<depth>& quote);
+
+    /**
+     * @brief Recompute a symbol's top of book after its quote was written in place.
+     */
+    void refreshTopOfBook(std::uint16_t symbolId);
+
     Quote<depth>& operator[](std::uint16_t symbolId);
     const Quote<depth>& operator[](std::uint16_t symbolId) const;
     const Quote<depth>& getQuote(std::uint16_t symbolId) const;
@@ -30,15 +54,41 @@ struct MarketState {
     const Ticks& getBidSize(std::size_t priceLevel, std::uint16_t symbolId) const;
     const Ticks& getAskSize(std::size_t priceLevel, std::uint16_t symbolId) const;
 
-    std::array<Ticks, depth> getBids(std::uint16_t symbolId) const;
-    std::array<Ticks, depth> getAsks(std::uint16_t symbolId) const;
-    std::array<Ticks, depth> getBidSizes(std::uint16_t symbolId) const;
-    std::array<Ticks, depth> getAskSizes(std::uint16_t symbolId) const;
+    std::span<const Ticks, depth> getBids(std::uint16_t symbolId) const;
+    std::span<const Ticks, depth> getAsks(std::uint16_t symbolId) const;
+    std::span<const Ticks, depth> getBidSizes(std::uint16_t symbolId) const;
+    std::span<const Ticks, depth> getAskSizes(std::uint16_t symbolId) const;
 
     std::array<Ticks, numberOfSymbols> getBestBids() const;
     std::array<Ticks, numberOfSymbols> getBestAsks() const;
+
+    // Zero-copy views of the top of book of every symbol
+    std::span<const Ticks, numberOfSymbols> bestBids() const { return topBids; }
+    std::span<const Ticks, numberOfSymbols> bestAsks() const { return topAsks; }
+    std::span<const Ticks, numberOfSymbols> bestBidSizes() const { return topBidSizes; }
+    std::span<const Ticks, numberOfSymbols> bestAskSizes() const { return topAskSizes; }
 };
 
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+inline void MarketState<depth, numberOfSymbols>::setQuote(std::uint16_t symbolId,
+    const Quote<depth>& quote) {
+    assert(symbolId < numberOfSymbols);
+    data[symbolId] = quote;
+    refreshTopOfBook(symbolId);
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+inline void MarketState<depth, numberOfSymbols>::refreshTopOfBook(std::uint16_t symbolId) {
+    const Quote<depth>& quote = data[symbolId];
+    const std::size_t bidLevel = quote.bestBidLevel();
+    const std::size_t askLevel = quote.bestAskLevel();
+
+    topBids[symbolId] = quote.prices[bidLevel];
+    topAsks[symbolId] = quote.prices[depth + askLevel];
+    topBidSizes[symbolId] = quote.sizes[bidLevel];
+    topAskSizes[symbolId] = quote.sizes[depth + askLevel];
+}
+
 template <std::size_t depth, std::uint16_t numberOfSymbols>
 inline Quote<depth>& MarketState<depth, numberOfSymbols>::operator[](std::uint16_t symbolId) {
     assert(symbolId < numberOfSymbols);
@@ -52,13 +102,13 @@ inline const Quote<depth>& MarketState<depth, numberOfSymbols>::operator[](
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols>
-inline std::array<Ticks, depth> MarketState<depth, numberOfSymbols>::getBidSizes(
+inline std::span<const Ticks, depth> MarketState<depth, numberOfSymbols>::getBidSizes(
     std::uint16_t symbolId) const {
     return data[symbolId].getBidSizes();
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols>
-inline std::array<Ticks, depth> MarketState<depth, numberOfSymbols>::getAskSizes(
+inline std::span<const Ticks, depth> MarketState<depth, numberOfSymbols>::getAskSizes(
     std::uint16_t symbolId) const {
     return data[symbolId].getAskSizes();
 }
@@ -71,30 +121,22 @@ inline const Quote<depth>& MarketState<depth, numberOfSymbols>::getQuote(
 
 template <std::size_t depth, std::uint16_t numberOfSymbols>
 inline std::array<Ticks, numberOfSymbols> MarketState<depth, numberOfSymbols>::getBestBids() const {
-    std::array<Ticks, numberOfSymbols> bestBids;
-    for (std::uint16_t i = 0; i < numberOfSymbols; ++i) {
-        bestBids[i] = bestBid(i);
-    }
-    return bestBids;
+    return topBids;
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols>
 inline std::array<Ticks, numberOfSymbols> MarketState<depth, numberOfSymbols>::getBestAsks() const {
-    std::array<Ticks, numberOfSymbols> bestAsks;
-    for (std::uint16_t i = 0; i < numberOfSymbols; ++i) {
-        bestAsks[i] = bestAsk(i);
-    }
-    return bestAsks;
+    return topAsks;
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols>
 inline const Ticks& MarketState<depth, numberOfSymbols>::bestBid(std::uint16_t symbolId) const {
-    return data[symbolId].bestBid();
+    return topBids[symbolId];
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols>
 inline const Ticks& MarketState<depth, numberOfSymbols>::bestAsk(std::uint16_t symbolId) const {
-    return data[symbolId].bestAsk();
+    return topAsks[symbolId];
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols>
@@ -122,13 +164,13 @@ inline const Ticks& MarketState<depth, numberOfSymbols>::getAskSize(std::size_t
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols>
-inline std::array<Ticks, depth> MarketState<depth, numberOfSymbols>::getBids(
+inline std::span<const Ticks, depth> MarketState<depth, numberOfSymbols>::getBids(
     std::uint16_t symbolId) const {
     return data[symbolId].getBids();
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols>
-inline std::array<Ticks, depth> MarketState<depth, numberOfSymbols>::getAsks(
+inline std::span<const Ticks, depth> MarketState<depth, numberOfSymbols>::getAsks(
     std::uint16_t symbolId) const {
     return data[symbolId].getAsks();
 }
@@ -87,8 +87,9 @@ export namespace sim {
     */
     struct PendingOrder {
         NewOrder order;
-        TimeStamp sendTime;           // When order was sent
-        TimeStamp earliestExecution;  // When order can execute (sendTime + latency)
+        TimeStamp sendTime;             // When order was sent
+        TimeStamp earliestExecution;    // When order can execute (sendTime + latency)
+        std::uint32_t fillAttempts{0};  // Times the order has been offered to the market
     };
 
     /**
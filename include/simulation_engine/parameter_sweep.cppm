@@ -0,0 +1,350 @@
+// parameter_sweep.cppm
+export module simulation_engine:parameter_sweep;
+
+import :engine;
+import :engine_policies;
+import :market_data;
+import :quote;
+import :run_params;
+import :snapshot;
+import :statistics;
+import :strategy_interface;
+import :types;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief A quote dataset decoded once and shared read-only by concurrent runs
+ * @details
+ * Holds one row-layout quote buffer per file, in replay order. The store is immutable after
+ * construction and is handed around as std::shared_ptr<const SharedQuoteStore>, so any number of
+ * MarketDataShared cursors on any number of threads can read it without synchronization while
+ * the data itself exists once.
+ */
+template <std::size_t depth>
+class SharedQuoteStore {
+   public:
+    /**
+     * @param filePaths Name of each file, used in load reports and keyframe cache paths.
+     * @param files The quotes of each file; must be as long as filePaths.
+     */
+    SharedQuoteStore(std::vector<std::string> filePaths, std::vector<std::vector<Quote<depth>>> files)
+        : filePaths_(std::move(filePaths)), files_(std::move(files)) {}
+
+    /**
+     * @brief A store of a single in-memory quote stream.
+     */
+    explicit SharedQuoteStore(std::vector<Quote<depth>> quotes)
+        : filePaths_{std::string{}}, files_{} {
+        files_.push_back(std::move(quotes));
+    }
+
+    std::size_t numberOfFiles() const { return files_.size(); }
+    const std::vector<std::string>& filePaths() const { return filePaths_; }
+    std::span<const Quote<depth>> quotes(std::size_t fileIndex) const { return files_[fileIndex]; }
+
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const auto& file : files_) total += file.size();
+        return total;
+    }
+
+    /**
+     * @brief Approximate number of bytes held by the quotes.
+     */
+    std::size_t memoryUsage() const { return size() * sizeof(Quote<depth>); }
+
+   private:
+    std::vector<std::string> filePaths_;
+    std::vector<std::vector<Quote<depth>>> files_;
+};
+
+/**
+ * @brief Decode a set of Parquet quote files into a shared store.
+ * @details Each file is decoded once with readParquetQuotes, honouring the symbol filter, memory
+ * budget and decode threads of params.
+ * @param filePaths Files in replay order.
+ * @param params Market data parameters used for decoding.
+ * @param out Receives the store.
+ * @return False if any file could not be read.
+ */
+template <std::size_t depth>
+bool loadSharedQuoteStore(const std::vector<std::string>& filePaths,
+    const MarketDataParams& params,
+    std::shared_ptr<const SharedQuoteStore<depth>>& out) {
+    std::vector<std::vector<Quote<depth>>> files(filePaths.size());
+    for (std::size_t i = 0; i < filePaths.size(); ++i) {
+        if (!readParquetQuotes<depth>(filePaths[i], params, files[i])) return false;
+    }
+    out = std::make_shared<const SharedQuoteStore<depth>>(filePaths, std::move(files));
+    return true;
+}
+
+/**
+ * @brief Market data read from a SharedQuoteStore through a private cursor
+ * @details
+ * Each instance keeps its own position, market state and keyframe indexes, but serves the
+ * store's buffers directly as its quote view, so a run costs no decoding and no copy of the
+ * quotes. The row layout is always used and prefetching is disabled, since re-encoding or
+ * reloading a shared buffer would defeat the point.
+ */
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+class MarketDataShared : public IMarketData<depth, numberOfSymbols> {
+   public:
+    MarketDataShared(std::shared_ptr<const SharedQuoteStore<depth>> store,
+        const MarketDataParams& params = {})
+        : IMarketData<depth, numberOfSymbols>(store->filePaths(), true, sharedParams(params)),
+          store_(std::move(store)) {
+        this->loadFile(0);
+    }
+
+   protected:
+    // The base class sets currentFileIndex before asking for a file, so nothing is read here
+    bool loadData() override { return this->currentFileIndex < store_->numberOfFiles(); }
+    bool loadData(const std::string&) override { return loadData(); }
+
+    bool streamsBatches() const override { return false; }
+
+    std::optional<std::span<const Quote<depth>>> externalQuotes() const override {
+        return store_->quotes(this->currentFileIndex);
+    }
+
+   private:
+    static MarketDataParams sharedParams(MarketDataParams params) {
+        params.layout = QuoteLayout::Rows;
+        params.streaming = false;
+        params.prefetchDepth = 0;
+        return params;
+    }
+
+    std::shared_ptr<const SharedQuoteStore<depth>> store_;
+};
+
+/**
+ * @brief One run of a parameter sweep
+ * @details result is empty if the run threw, in which case error holds the exception message.
+ */
+template <std::uint16_t numberOfSymbols, typename Distribution, typename Parameters>
+struct SweepRow {
+    Parameters parameters;
+    std::optional<Result<numberOfSymbols, Distribution>> result;
+    std::string report;  // Summary the run printed
+    std::chrono::nanoseconds runTime{0};
+    std::string error;
+};
+
+/**
+ * @brief Results of a parameter sweep, one row per parameter set in the order they were given
+ */
+template <std::uint16_t numberOfSymbols, typename Distribution, typename Parameters>
+struct SweepTable {
+    std::vector<SweepRow<numberOfSymbols, Distribution, Parameters>> rows;
+    std::chrono::nanoseconds wallTime{0};
+
+    /**
+     * @brief The row of a parameter set.
+     * @return Null if the set was not part of the sweep.
+     */
+    const SweepRow<numberOfSymbols, Distribution, Parameters>* find(
+        const Parameters& parameters) const
+        requires std::equality_comparable<Parameters>
+    {
+        for (const auto& row : rows) {
+            if (row.parameters == parameters) return &row;
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Run many Engine and strategy instances over one shared dataset on a pool of threads
+ * @details
+ * Every run gets its own MarketDataShared cursor, Engine and strategy, built from the parameter
+ * set by the caller's factories; only the quote store is shared. Runs are independent and long,
+ * so idle workers simply claim the next unstarted run from a shared counter, which balances
+ * uneven run lengths without any per-run queue. Memory is one copy of the dataset plus the state
+ * of the runs in flight. Every run is compiled with Policies, e.g. RawThroughput for sweeps that
+ * only explore signal parameters.
+ */
+template <std::size_t depth,
+    std::uint16_t numberOfSymbols,
+    typename Distribution,
+    EnginePolicySet Policies = FullRealism>
+class ParameterSweep {
+   public:
+    using Strategy = IStrategy<depth, numberOfSymbols, Distribution>;
+
+    /**
+     * @param store The dataset every run replays.
+     * @param numberOfThreads Runs executed at once; 0 uses every hardware thread.
+     */
+    ParameterSweep(std::shared_ptr<const SharedQuoteStore<depth>> store,
+        std::size_t numberOfThreads = 0)
+        : store_(std::move(store)),
+          numberOfThreads_(numberOfThreads != 0
+                  ? numberOfThreads
+                  : std::max<std::size_t>(std::thread::hardware_concurrency(), 1)) {}
+
+    /**
+     * @brief Run every parameter set and collect the results.
+     * @param grid The parameter sets, one run each.
+     * @param makeRunParams Callable taking a parameter set and returning its
+     * RunParams<Distribution>.
+     * @param makeStrategy Callable taking a parameter set and its RunParams and returning a
+     * std::unique_ptr to a new strategy. Both factories are called concurrently from the workers.
+     * @return One row per parameter set, in grid order.
+     */
+    template <typename Parameters, typename MakeRunParams, typename MakeStrategy>
+    SweepTable<numberOfSymbols, Distribution, Parameters> run(const std::vector<Parameters>& grid,
+        MakeRunParams makeRunParams,
+        MakeStrategy makeStrategy) const {
+        return runGrid(grid, makeRunParams, makeStrategy, nullptr);
+    }
+
+    /**
+     * @brief Continue one paused run under every parameter set, as independent branches.
+     * @details
+     * Each run builds its RunParams and strategy as in run, restores prefix into them with
+     * Engine::restore and plays the rest of the dataset, so the branches share everything before
+     * the pause without replaying it. The strategies must load the state the snapshotted
+     * strategy saved. RunParams may differ between branches, e.g. in fixed latencies or fill-rate
+     * distributions, but must sample latencies the same way as the prefix; every branch keeps
+     * the prefix's fill-rate seed. A branch whose restore fails is reported as an error.
+     * @param prefix Snapshot of a run over this sweep's dataset.
+     * @param grid The parameter sets, one branch each.
+     * @param makeRunParams Callable taking a parameter set and returning its
+     * RunParams<Distribution>.
+     * @param makeStrategy Callable taking a parameter set and its RunParams and returning a
+     * std::unique_ptr to a new strategy.
+     * @return One row per parameter set, in grid order.
+     */
+    template <typename Parameters, typename MakeRunParams, typename MakeStrategy>
+    SweepTable<numberOfSymbols, Distribution, Parameters> runFrom(const EngineSnapshot& prefix,
+        const std::vector<Parameters>& grid,
+        MakeRunParams makeRunParams,
+        MakeStrategy makeStrategy) const {
+        return runGrid(grid, makeRunParams, makeStrategy, &prefix);
+    }
+
+    /**
+     * @brief Replay one strategy many times with independent fill-rate streams.
+     * @details
+     * Trial i runs params with fillRateSeed set to the base seed and trialIndex to i, so only the
+     * fill-rate draws differ between trials and any trial can be reproduced from its index alone.
+     * Trials are run concurrently like any other sweep. The spread of the results is printed to
+     * out when params asks for DETAILED verbosity; each trial itself reports nothing.
+     * @param params Parameters shared by every trial. If fillRateSeed is empty a base seed is
+     * drawn once from std::random_device and recorded in the returned statistics.
+     * @param numberOfTrials Number of trials, with indices 0 to numberOfTrials - 1.
+     * @param makeStrategy Callable taking the trial's RunParams and returning a std::unique_ptr
+     * to a new strategy.
+     * @param out Stream the DETAILED report is written to.
+     * @return The metrics of every trial.
+     */
+    template <typename MakeStrategy>
+    TrialStatistics runFillModelTrials(RunParams<Distribution> params,
+        std::size_t numberOfTrials,
+        MakeStrategy makeStrategy,
+        std::ostream& out = std::cout) const {
+        if (!params.fillRateSeed) {
+            std::random_device device;
+            params.fillRateSeed = (std::uint64_t{device()} << 32) | device();
+        }
+        const VerbosityLevel verbosity = params.verbosityLevel;
+        params.verbosityLevel = VerbosityLevel::MINIMAL;
+
+        std::vector<std::uint64_t> trialIndices(numberOfTrials);
+        std::iota(trialIndices.begin(), trialIndices.end(), std::uint64_t{0});
+
+        auto table = run(
+            trialIndices,
+            [&params](std::uint64_t trialIndex) {
+                RunParams<Distribution> trialParams = params;
+                trialParams.trialIndex = trialIndex;
+                return trialParams;
+            },
+            [&makeStrategy](std::uint64_t, const RunParams<Distribution>& trialParams) {
+                return makeStrategy(trialParams);
+            });
+
+        TrialStatistics statistics(*params.fillRateSeed);
+        for (const auto& row : table.rows) {
+            if (row.result) {
+                statistics.add(row.parameters, row.result->metrics);
+            } else {
+                statistics.addFailure(row.parameters, row.error);
+            }
+        }
+        if (verbosity == VerbosityLevel::DETAILED) statistics.outputDetailed(out);
+        return statistics;
+    }
+
+    std::size_t numberOfThreads() const { return numberOfThreads_; }
+
+   private:
+    template <typename Parameters, typename MakeRunParams, typename MakeStrategy>
+    SweepTable<numberOfSymbols, Distribution, Parameters> runGrid(
+        const std::vector<Parameters>& grid,
+        MakeRunParams& makeRunParams,
+        MakeStrategy& makeStrategy,
+        const EngineSnapshot* prefix) const {
+        SweepTable<numberOfSymbols, Distribution, Parameters> table;
+        table.rows.reserve(grid.size());
+        for (const Parameters& parameters : grid) table.rows.push_back({parameters});
+
+        const auto start = std::chrono::steady_clock::now();
+        std::atomic<std::size_t> nextRun{0};
+        {
+            std::vector<std::jthread> workers;
+            const std::size_t numberOfWorkers = std::min(numberOfThreads_, grid.size());
+            for (std::size_t i = 0; i < numberOfWorkers; ++i) {
+                workers.emplace_back([&] {
+                    for (std::size_t runIndex = nextRun.fetch_add(1); runIndex < grid.size();
+                        runIndex = nextRun.fetch_add(1)) {
+                        runOne(table.rows[runIndex], makeRunParams, makeStrategy, prefix);
+                    }
+                });
+            }
+        }
+        table.wallTime = std::chrono::steady_clock::now() - start;
+        return table;
+    }
+
+    template <typename Parameters, typename MakeRunParams, typename MakeStrategy>
+    void runOne(SweepRow<numberOfSymbols, Distribution, Parameters>& row,
+        MakeRunParams& makeRunParams,
+        MakeStrategy& makeStrategy,
+        const EngineSnapshot* prefix) const {
+        const Parameters& parameters = row.parameters;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            RunParams<Distribution> runParams = makeRunParams(parameters);
+            std::unique_ptr<Strategy> strategy = makeStrategy(parameters, runParams);
+
+            Engine<depth, numberOfSymbols, Distribution> engine(
+                std::make_unique<MarketDataShared<depth, numberOfSymbols>>(
+                    store_, runParams.marketData),
+                runParams);
+            if (prefix != nullptr && !engine.restore(*prefix, *strategy)) {
+                row.error = "snapshot could not be restored";
+                row.runTime = std::chrono::steady_clock::now() - start;
+                return;
+            }
+
+            std::ostringstream report;
+            row.result = engine.template run<Policies>(*strategy, report);
+            row.report = std::move(report).str();
+            if (!row.result.marketDataError.empty()) row.error = row.result.marketDataError;
+        } catch (const std::exception& exception) {
+            row.error = exception.what();
+        }
+        row.runTime = std::chrono::steady_clock::now() - start;
+    }
+
+    std::shared_ptr<const SharedQuoteStore<depth>> store_;
+    std::size_t numberOfThreads_;
+};
+
+}  // namespace sim
@@ -0,0 +1,230 @@
+// pending_order_store.cppm
+export module simulation_engine:pending_order_store;
+
+import :order_placement;
+import :snapshot;
+import :types;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief Pending orders indexed by OrderId
+ * @details
+ * Orders live in a slot vector whose freed slots are reused, so an order never moves once
+ * inserted. A hash map from OrderId to slot gives constant time lookup, and the occupied slots
+ * are threaded on a doubly linked list in insertion order, so erasing from the middle is
+ * constant time while iteration still visits orders in the order they were placed, which is the
+ * order they are offered to the market.
+ */
+class PendingOrderStore {
+    static constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
+    struct Slot {
+        PendingOrder pendingOrder;
+        std::uint32_t previous{kNoSlot};
+        std::uint32_t next{kNoSlot};
+    };
+
+   public:
+    template <bool isConst>
+    class Iterator {
+       public:
+        using StoreType = std::conditional_t<isConst, const PendingOrderStore, PendingOrderStore>;
+        using value_type = PendingOrder;
+        using reference = std::conditional_t<isConst, const PendingOrder&, PendingOrder&>;
+        using pointer = std::conditional_t<isConst, const PendingOrder*, PendingOrder*>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        Iterator() = default;
+        Iterator(StoreType* store, std::uint32_t slot) : store_(store), slot_(slot) {}
+
+        reference operator*() const { return store_->slots_[slot_].pendingOrder; }
+        pointer operator->() const { return &store_->slots_[slot_].pendingOrder; }
+
+        Iterator& operator++() {
+            slot_ = store_->slots_[slot_].next;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.slot_ == b.slot_; }
+
+       private:
+        friend class PendingOrderStore;
+
+        StoreType* store_{nullptr};
+        std::uint32_t slot_{kNoSlot};
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    iterator begin() { return iterator(this, head_); }
+    iterator end() { return iterator(this, kNoSlot); }
+    const_iterator begin() const { return const_iterator(this, head_); }
+    const_iterator end() const { return const_iterator(this, kNoSlot); }
+
+    std::size_t size() const { return slotById_.size(); }
+    bool empty() const { return slotById_.empty(); }
+
+    void reserve(std::size_t numberOfOrders) {
+        slots_.reserve(numberOfOrders);
+        slotById_.reserve(numberOfOrders);
+    }
+
+    /**
+     * @brief Add an order at the end of the insertion order.
+     * @details An order with the same id already in the store is replaced in place.
+     * @return The stored order.
+     */
+    PendingOrder& insert(const PendingOrder& pendingOrder);
+
+    /**
+     * @return The order with orderId, or null if it is not pending.
+     */
+    PendingOrder* find(OrderId orderId);
+    const PendingOrder* find(OrderId orderId) const;
+
+    bool contains(OrderId orderId) const { return slotById_.contains(orderId.value()); }
+
+    /**
+     * @brief Remove the order with orderId.
+     * @return False if it was not pending.
+     */
+    bool erase(OrderId orderId);
+
+    /**
+     * @brief Remove the order at position, for use while iterating.
+     * @return Iterator to the order placed after it.
+     */
+    iterator erase(iterator position);
+
+    void clear();
+
+    /**
+     * @brief Write the orders to a snapshot in insertion order.
+     */
+    void save(SnapshotWriter& out) const;
+
+    /**
+     * @brief Replace the contents with orders written by save, keeping their order.
+     * @return False if the snapshot is truncated.
+     */
+    bool load(SnapshotReader& in);
+
+   private:
+    void unlink(std::uint32_t slot);
+
+    std::vector<Slot> slots_;
+    std::vector<std::uint32_t> freeSlots_;
+    std::unordered_map<std::uint64_t, std::uint32_t> slotById_;
+    std::uint32_t head_{kNoSlot};
+    std::uint32_t tail_{kNoSlot};
+};
+
+inline PendingOrder& PendingOrderStore::insert(const PendingOrder& pendingOrder) {
+    auto [it, inserted] = slotById_.try_emplace(pendingOrder.order.id.value(), kNoSlot);
+    if (!inserted) {
+        Slot& existing = slots_[it->second];
+        existing.pendingOrder = pendingOrder;
+        return existing.pendingOrder;
+    }
+
+    std::uint32_t slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        slot = static_cast<std::uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+    it->second = slot;
+
+    Slot& stored = slots_[slot];
+    stored.pendingOrder = pendingOrder;
+    stored.previous = tail_;
+    stored.next = kNoSlot;
+    if (tail_ != kNoSlot) {
+        slots_[tail_].next = slot;
+    } else {
+        head_ = slot;
+    }
+    tail_ = slot;
+    return stored.pendingOrder;
+}
+
+inline PendingOrder* PendingOrderStore::find(OrderId orderId) {
+    auto it = slotById_.find(orderId.value());
+    return (it != slotById_.end()) ? &slots_[it->second].pendingOrder : nullptr;
+}
+
+inline const PendingOrder* PendingOrderStore::find(OrderId orderId) const {
+    auto it = slotById_.find(orderId.value());
+    return (it != slotById_.end()) ? &slots_[it->second].pendingOrder : nullptr;
+}
+
+inline void PendingOrderStore::unlink(std::uint32_t slot) {
+    Slot& removed = slots_[slot];
+    if (removed.previous != kNoSlot) {
+        slots_[removed.previous].next = removed.next;
+    } else {
+        head_ = removed.next;
+    }
+    if (removed.next != kNoSlot) {
+        slots_[removed.next].previous = removed.previous;
+    } else {
+        tail_ = removed.previous;
+    }
+    freeSlots_.push_back(slot);
+}
+
+inline bool PendingOrderStore::erase(OrderId orderId) {
+    auto it = slotById_.find(orderId.value());
+    if (it == slotById_.end()) return false;
+
+    unlink(it->second);
+    slotById_.erase(it);
+    return true;
+}
+
+inline PendingOrderStore::iterator PendingOrderStore::erase(iterator position) {
+    const std::uint32_t next = slots_[position.slot_].next;
+    slotById_.erase(slots_[position.slot_].pendingOrder.order.id.value());
+    unlink(position.slot_);
+    return iterator(this, next);
+}
+
+inline void PendingOrderStore::clear() {
+    slots_.clear();
+    freeSlots_.clear();
+    slotById_.clear();
+    head_ = kNoSlot;
+    tail_ = kNoSlot;
+}
+
+inline void PendingOrderStore::save(SnapshotWriter& out) const {
+    out.write(static_cast<std::uint64_t>(size()));
+    for (const PendingOrder& pendingOrder : *this) out.write(pendingOrder);
+}
+
+inline bool PendingOrderStore::load(SnapshotReader& in) {
+    std::uint64_t numberOfOrders = 0;
+    if (!in.read(numberOfOrders)) return false;
+
+    clear();
+    for (std::uint64_t i = 0; i < numberOfOrders; ++i) {
+        PendingOrder pendingOrder;
+        if (!in.read(pendingOrder)) return false;
+        insert(pendingOrder);
+    }
+    return true;
+}
+
+}  // namespace sim
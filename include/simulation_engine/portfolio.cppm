@@ -5,6 +5,7 @@ import :probability_distributions;
 import :order_placement;
 import :types;
 import :run_params;
+import :snapshot;
 
 import std;
 
@@ -55,6 +56,17 @@ class Portfolio {
      */
     void updatePortfolio(const Fill& fill);
 
+    /**
+     * @brief Move a symbol's mark to its new top of book.
+     * @details Only that symbol's contribution to the marked long and short market values is
+     * adjusted, by the price change times the position, so this is O(1) whatever the number of
+     * symbols. Mark every symbol once before relying on the marked values.
+     * @param symbolId The symbol whose quote changed.
+     * @param bestBid Its new best bid, at which longs are valued.
+     * @param bestAsk Its new best ask, at which shorts are valued.
+     */
+    void markToMarket(std::uint16_t symbolId, Ticks bestBid, Ticks bestAsk);
+
     /**
      * @brief Determine the amount of additional borrowing required to fund a purchase.
      * @details Compares the purchase cost against available total cash to find the shortfall.
@@ -129,18 +141,28 @@ class Portfolio {
     /**
      * @brief Calculate the total market value of all long positions.
      * @details Sums (Quantity * Bid Price) for all symbols where quantity is positive.
-     * @param bestBids An array of the current best bid prices for all symbols in the universe.
+     * @param bestBids View of the current best bid prices for all symbols in the universe.
      * @return The gross value of all owned assets.
      */
-    Ticks longMarketValue(const std::array<Ticks, numberOfSymbols>& bestBids) const;
+    Ticks longMarketValue(std::span<const Ticks, numberOfSymbols> bestBids) const;
+
+    /**
+     * @brief Market value of all long positions at the marked prices, maintained incrementally.
+     */
+    Ticks longMarketValue() const { return longMarketValue_; }
 
     /**
      * @brief Calculate the total market value of all short positions.
      * @details Sums (ABS(Quantity) * Ask Price) for all symbols where quantity is negative.
-     * @param bestAsks An array of the current best ask prices (cost to cover) for all symbols.
+     * @param bestAsks View of the current best ask prices (cost to cover) for all symbols.
      * @return The absolute cost required to buy back all shorted shares.
      */
-    Ticks shortMarketValue(const std::array<Ticks, numberOfSymbols>& bestAsks) const;
+    Ticks shortMarketValue(std::span<const Ticks, numberOfSymbols> bestAsks) const;
+
+    /**
+     * @brief Market value of all short positions at the marked prices, maintained incrementally.
+     */
+    Ticks shortMarketValue() const { return shortMarketValue_; }
 
     /**
      * @brief Calculate the total absolute exposure of the portfolio.
@@ -149,8 +171,13 @@ class Portfolio {
      * @param bestAsks Current best ask prices.
      * @return Total market footprint used for leverage and risk limit calculations.
      */
-    Ticks grossMarketValue(const std::array<Ticks, numberOfSymbols>& bestBids,
-        const std::array<Ticks, numberOfSymbols>& bestAsks) const;
+    Ticks grossMarketValue(std::span<const Ticks, numberOfSymbols> bestBids,
+        std::span<const Ticks, numberOfSymbols> bestAsks) const;
+
+    /**
+     * @brief Gross market value at the marked prices.
+     */
+    Ticks grossMarketValue() const { return longMarketValue_ + shortMarketValue_; }
 
     /**
      * @brief Calculate the net directional exposure of the portfolio.
@@ -159,8 +186,8 @@ class Portfolio {
      * @param bestAsks Current best ask prices.
      * @return The directional bias (Positive = Net Long, Negative = Net Short).
      */
-    Ticks netMarketValue(const std::array<Ticks, numberOfSymbols>& bestBids,
-        const std::array<Ticks, numberOfSymbols>& bestAsks) const;
+    Ticks netMarketValue(std::span<const Ticks, numberOfSymbols> bestBids,
+        std::span<const Ticks, numberOfSymbols> bestAsks) const;
 
     /**
      * @brief Calculate the "True Value" or Net Worth of the account.
@@ -170,8 +197,15 @@ class Portfolio {
      * @param bestAsks Current best ask prices.
      * @return Total equity available if all positions were closed immediately.
      */
-    Ticks netLiquidationValue(const std::array<Ticks, numberOfSymbols>& bestBids,
-        const std::array<Ticks, numberOfSymbols>& bestAsks) const;
+    Ticks netLiquidationValue(std::span<const Ticks, numberOfSymbols> bestBids,
+        std::span<const Ticks, numberOfSymbols> bestAsks) const;
+
+    /**
+     * @brief Net liquidation value at the marked prices.
+     */
+    Ticks netLiquidationValue() const {
+        return cash + longMarketValue_ - shortMarketValue_ - (loan + interestOwed);
+    }
 
     /**
      * @brief Calculate the minimum equity required by the broker to keep positions open.
@@ -179,24 +213,55 @@ class Portfolio {
      * @param prices Current market prices for the symbols held.
      * @return The minimum Net Liquidation Value required to avoid a margin call.
      */
-    Ticks maintenanceRequirement(const std::array<Ticks, numberOfSymbols>& bestBids,
-        const std::array<Ticks, numberOfSymbols>& bestAsks) const;
+    Ticks maintenanceRequirement(std::span<const Ticks, numberOfSymbols> bestBids,
+        std::span<const Ticks, numberOfSymbols> bestAsks) const;
+
+    /**
+     * @brief Maintenance requirement at the marked prices.
+     */
+    Ticks maintenanceRequirement() const { return grossMarketValue() * 3 / 10; }
+
+    /**
+     * @brief Check whether equity is below the maintenance requirement.
+     */
+    bool violatesMarginRequirement(std::span<const Ticks, numberOfSymbols> bestBids,
+        std::span<const Ticks, numberOfSymbols> bestAsks) const;
 
     /**
+     * @brief Margin check at the marked prices, in O(1).
      */
-    bool violatesMarginRequirement(const std::array<Ticks, numberOfSymbols>& bestBids,
-        const std::array<Ticks, numberOfSymbols>& bestAsks) const;
+    bool violatesMarginRequirement() const {
+        return netLiquidationValue() < maintenanceRequirement();
+    }
 
     /**
      * @brief Validate if an order can be placed without violating margin or leverage limits.
 
      */
-    bool sufficientEquityForOrder(const std::array<Ticks, numberOfSymbols>& bestBids,
-        const std::array<Ticks, numberOfSymbols>& bestAsks,
+    bool sufficientEquityForOrder(std::span<const Ticks, numberOfSymbols> bestBids,
+        std::span<const Ticks, numberOfSymbols> bestAsks,
         const NewOrder& order,
         Ticks totalOrderPrice,
         double leverageFactor) const;
 
+    /**
+     * @brief Order validation at the marked prices.
+     */
+    bool sufficientEquityForOrder(const NewOrder& order,
+        Ticks totalOrderPrice,
+        double leverageFactor) const;
+
+    /**
+     * @brief Write the balances, positions and marks to a snapshot.
+     */
+    void save(SnapshotWriter& out) const;
+
+    /**
+     * @brief Replace the portfolio with one written by save.
+     * @return False if the snapshot is truncated.
+     */
+    bool load(SnapshotReader& in);
+
    private:
     /**
      * @brief Update cost basis with weighted average calculation
@@ -204,6 +269,26 @@ class Portfolio {
      * @param fillQuantity Quantity of the new fill
      */
     void updateCostBasis(std::uint16_t symbolId, Ticks fillPrice, Quantity fillQuantity);
+
+    /**
+     * @brief Order validation against a given net liquidation and gross market value.
+     */
+    bool sufficientEquityForOrder(const NewOrder& order,
+        Ticks totalOrderPrice,
+        double leverageFactor,
+        Ticks currentNetLiquidationValue,
+        Ticks currentGrossMarketValue) const;
+
+    /**
+     * @brief Fold a change of position in one symbol into the marked market values.
+     */
+    void revaluePosition(std::uint16_t symbolId, Quantity previousLong, Quantity previousShort);
+
+    // Top of book each symbol was last marked at, and the market values at those marks
+    std::array<Ticks, numberOfSymbols> markBids_{};
+    std::array<Ticks, numberOfSymbols> markAsks_{};
+    Ticks longMarketValue_{0};
+    Ticks shortMarketValue_{0};
 };
 
 }  // namespace sim
@@ -3,11 +3,339 @@ export module simulation_engine:probability_distributions;
 
 import std;
 
+import :random_streams;
+import :snapshot;
+
 export namespace sim {
 
+/**
+ * @brief A distribution the engine can sample fill rates and latencies from
+ * @details
+ * operator() draws one value from a RandomStream and fill draws a whole block at once. Both
+ * must be const: a distribution only describes the shape, all state lives in the stream, so one
+ * distribution can be shared by any number of streams and threads.
+ */
+template <typename D>
+concept SamplingDistribution =
+    std::copy_constructible<D> &&
+    requires(const D& distribution, RandomStream& stream, std::span<double> out) {
+        { distribution(stream) } -> std::convertible_to<double>;
+        distribution.fill(stream, out);
+    };
+
+/**
+ * @brief A standard normal draw from two uniforms (the cosine half of Box-Muller).
+ * @details One normal per pair of uniforms, so a batch of uniforms maps to normals without any
+ * carried state and scalar and batched draws agree.
+ */
+inline double standardNormalFromUniforms(double u1, double u2) {
+    return std::sqrt(-2.0 * std::log1p(-u1)) * std::cos(2.0 * std::numbers::pi * u2);
+}
+
 struct ConstantDistribution {
     double rate;
-    double operator()(std::mt19937&) const { return rate; }
+
+    template <typename Generator>
+    double operator()(Generator&) const {
+        return rate;
+    }
+
+    void fill(RandomStream&, std::span<double> out) const { std::ranges::fill(out, rate); }
+};
+
+/**
+ * @brief Beta distribution scaled to [0, scale]
+ * @details The default scale of 100 makes it a fill rate in percent. Drawn as X / (X + Y) from
+ * two gamma draws.
+ */
+struct BetaDistribution {
+    double alpha{1.0};
+    double beta{1.0};
+    double scale{100.0};
+
+    double operator()(RandomStream& stream) const {
+        const double x = std::gamma_distribution<double>{alpha, 1.0}(stream);
+        const double y = std::gamma_distribution<double>{beta, 1.0}(stream);
+        return (x + y > 0.0) ? scale * x / (x + y) : 0.0;
+    }
+
+    // Gamma draws are rejection sampled, so a block is just a run of single draws
+    void fill(RandomStream& stream, std::span<double> out) const {
+        for (double& value : out) value = (*this)(stream);
+    }
+};
+
+/**
+ * @brief exp(N(logMean, logStandardDeviation^2))
+ * @details A right-skewed positive distribution, e.g. for network latency in nanoseconds.
+ */
+struct LogNormalDistribution {
+    double logMean{0.0};
+    double logStandardDeviation{1.0};
+
+    double operator()(RandomStream& stream) const {
+        const double u1 = stream.uniform();
+        const double u2 = stream.uniform();
+        return std::exp(logMean + logStandardDeviation * standardNormalFromUniforms(u1, u2));
+    }
+
+    void fill(RandomStream& stream, std::span<double> out) const {
+        constexpr std::size_t chunk = 128;
+        std::array<double, 2 * chunk> uniforms;
+        for (std::size_t begin = 0; begin < out.size(); begin += chunk) {
+            const std::size_t count = std::min(chunk, out.size() - begin);
+            stream.fillUniform(std::span<double>{uniforms.data(), 2 * count});
+            for (std::size_t i = 0; i < count; ++i) {
+                out[begin + i] = std::exp(logMean +
+                    logStandardDeviation *
+                        standardNormalFromUniforms(uniforms[2 * i], uniforms[2 * i + 1]));
+            }
+        }
+    }
+};
+
+/**
+ * @brief Piecewise uniform distribution of a histogram
+ * @details
+ * Bin i covers [binEdges[i], binEdges[i + 1]) and is chosen with probability proportional to its
+ * weight; the value is uniform within the bin. Built with makeEmpiricalDistribution, e.g. from
+ * observed fill rates or measured round trips. The default is a point mass at zero.
+ */
+class EmpiricalDistribution {
+   public:
+    EmpiricalDistribution() : binEdges_{0.0, 0.0}, cumulativeProbabilities_{1.0} {}
+
+    double operator()(RandomStream& stream) const { return fromUniform(stream.uniform()); }
+
+    void fill(RandomStream& stream, std::span<double> out) const {
+        stream.fillUniform(out);
+        for (double& value : out) value = fromUniform(value);
+    }
+
+    std::span<const double> binEdges() const { return binEdges_; }
+
+   private:
+    friend bool makeEmpiricalDistribution(std::vector<double> binEdges,
+        std::span<const double> weights,
+        EmpiricalDistribution& out);
+
+    // Inverse of the piecewise linear CDF
+    double fromUniform(double u) const {
+        const std::size_t bin = std::min<std::size_t>(
+            std::ranges::upper_bound(cumulativeProbabilities_, u) -
+                cumulativeProbabilities_.begin(),
+            cumulativeProbabilities_.size() - 1);
+        const double binStart = (bin == 0) ? 0.0 : cumulativeProbabilities_[bin - 1];
+        const double binProbability = cumulativeProbabilities_[bin] - binStart;
+        const double position = (binProbability > 0.0) ? (u - binStart) / binProbability : 0.0;
+        return binEdges_[bin] + position * (binEdges_[bin + 1] - binEdges_[bin]);
+    }
+
+    std::vector<double> binEdges_;
+    std::vector<double> cumulativeProbabilities_;  // Probability of bins 0 to i
+};
+
+/**
+ * @brief Build the distribution of a histogram.
+ * @param binEdges Increasing bin boundaries, one more than there are weights.
+ * @param weights Non-negative weight of each bin, e.g. counts; they need not sum to one.
+ * @param out Receives the distribution.
+ * @return False if the edges or weights are malformed or the weights sum to zero.
+ */
+inline bool makeEmpiricalDistribution(std::vector<double> binEdges,
+    std::span<const double> weights,
+    EmpiricalDistribution& out) {
+    if (weights.empty() || binEdges.size() != weights.size() + 1) return false;
+    if (!std::ranges::is_sorted(binEdges)) return false;
+
+    std::vector<double> cumulative(weights.size());
+    double total = 0.0;
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        if (!(weights[i] >= 0.0)) return false;
+        total += weights[i];
+        cumulative[i] = total;
+    }
+    if (!(total > 0.0)) return false;
+    for (double& probability : cumulative) probability /= total;
+    cumulative.back() = 1.0;
+
+    out.binEdges_ = std::move(binEdges);
+    out.cumulativeProbabilities_ = std::move(cumulative);
+    return true;
+}
+
+/**
+ * @brief Weighted mixture of other distributions
+ * @details
+ * Each draw picks a component with probability proportional to its weight and samples it, e.g.
+ * a Beta fill rate mixed with a small chance of a constant zero when the queue never reaches the
+ * order. Components are held by value, so the mixture is dispatched statically. Built with
+ * makeMixtureDistribution; the default draws from a default first component only.
+ */
+template <SamplingDistribution... Components>
+class MixtureDistribution {
+   public:
+    MixtureDistribution()
+        requires(std::default_initializable<Components> && ...)
+    {
+        cumulativeWeights_.fill(1.0);
+    }
+
+    double operator()(RandomStream& stream) const {
+        const double u = stream.uniform();
+        const std::size_t component = std::min<std::size_t>(
+            std::ranges::upper_bound(cumulativeWeights_, u) - cumulativeWeights_.begin(),
+            sizeof...(Components) - 1);
+        return sampleComponent(component, stream, std::index_sequence_for<Components...>{});
+    }
+
+    void fill(RandomStream& stream, std::span<double> out) const {
+        for (double& value : out) value = (*this)(stream);
+    }
+
+   private:
+    template <SamplingDistribution... Parts>
+    friend bool makeMixtureDistribution(std::array<double, sizeof...(Parts)> weights,
+        std::tuple<Parts...> components,
+        MixtureDistribution<Parts...>& out);
+
+    MixtureDistribution(std::array<double, sizeof...(Components)> cumulativeWeights,
+        std::tuple<Components...> components)
+        : components_{std::move(components)}, cumulativeWeights_{cumulativeWeights} {}
+
+    template <std::size_t... indices>
+    double sampleComponent(std::size_t component,
+        RandomStream& stream,
+        std::index_sequence<indices...>) const {
+        double value = 0.0;
+        ((component == indices ? (value = std::get<indices>(components_)(stream), true) : false) ||
+            ...);
+        return value;
+    }
+
+    std::tuple<Components...> components_;
+    std::array<double, sizeof...(Components)> cumulativeWeights_{};
+};
+
+/**
+ * @brief Build a weighted mixture of distributions.
+ * @param weights Non-negative weight of each component; they need not sum to one.
+ * @param components The distributions mixed, in the order of their weights.
+ * @param out Receives the mixture.
+ * @return False if a weight is negative or not a number, or the weights sum to zero.
+ */
+template <SamplingDistribution... Components>
+bool makeMixtureDistribution(std::array<double, sizeof...(Components)> weights,
+    std::tuple<Components...> components,
+    MixtureDistribution<Components...>& out) {
+    std::array<double, sizeof...(Components)> cumulative{};
+    double total = 0.0;
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        if (!(weights[i] >= 0.0)) return false;
+        total += weights[i];
+        cumulative[i] = total;
+    }
+    if (!(total > 0.0)) return false;
+    for (double& probability : cumulative) probability /= total;
+    cumulative.back() = 1.0;
+
+    out = MixtureDistribution<Components...>(cumulative, std::move(components));
+    return true;
+}
+
+/**
+ * @brief Any SamplingDistribution behind one type
+ * @details
+ * Lets RunParams hold a distribution chosen at run time, such as a latency model. Each call goes
+ * through a virtual function, so it is meant to be drawn from in blocks with fill, e.g. through a
+ * SampleBuffer, where that cost is paid once per block. Copies share the wrapped distribution.
+ */
+class AnyDistribution {
+   public:
+    AnyDistribution() : AnyDistribution(ConstantDistribution{0.0}) {}
+
+    template <typename D>
+        requires(!std::same_as<D, AnyDistribution> && SamplingDistribution<D>)
+    AnyDistribution(D distribution)
+        : distribution_{std::make_shared<const Model<D>>(std::move(distribution))} {}
+
+    double operator()(RandomStream& stream) const { return distribution_->sample(stream); }
+
+    void fill(RandomStream& stream, std::span<double> out) const {
+        distribution_->fill(stream, out);
+    }
+
+   private:
+    struct Interface {
+        virtual ~Interface() = default;
+        virtual double sample(RandomStream& stream) const = 0;
+        virtual void fill(RandomStream& stream, std::span<double> out) const = 0;
+    };
+
+    template <typename D>
+    struct Model final : Interface {
+        explicit Model(D distribution) : distribution{std::move(distribution)} {}
+        double sample(RandomStream& stream) const override { return distribution(stream); }
+        void fill(RandomStream& stream, std::span<double> out) const override {
+            distribution.fill(stream, out);
+        }
+        D distribution;
+    };
+
+    std::shared_ptr<const Interface> distribution_;
+};
+
+/**
+ * @brief Pre-sampled draws of one distribution from one stream
+ * @details
+ * Refills a block of blockSize draws with a single fill call whenever it runs dry, so a
+ * stochastic model costs a load per draw in the hot path, like a constant.
+ */
+template <SamplingDistribution D>
+class SampleBuffer {
+   public:
+    SampleBuffer(D distribution, RandomStream stream, std::size_t blockSize = 256)
+        : distribution_{std::move(distribution)},
+          stream_{stream},
+          samples_(std::max<std::size_t>(blockSize, 1)),
+          position_{samples_.size()} {}
+
+    double next() {
+        if (position_ == samples_.size()) {
+            distribution_.fill(stream_, samples_);
+            position_ = 0;
+        }
+        return samples_[position_++];
+    }
+
+    /**
+     * @brief Write the stream position and the draws not yet taken to a snapshot.
+     * @details The distribution is not written; a restored buffer must be built from the same
+     * one, e.g. from the same RunParams.
+     */
+    void save(SnapshotWriter& out) const {
+        out.write(stream_);
+        out.write(samples_);
+        out.write(static_cast<std::uint64_t>(position_));
+    }
+
+    /**
+     * @brief Continue from the point a buffer was saved at.
+     * @return False if the snapshot is truncated.
+     */
+    bool load(SnapshotReader& in) {
+        std::uint64_t position = 0;
+        if (!in.read(stream_) || !in.read(samples_) || !in.read(position)) return false;
+        if (samples_.empty() || position > samples_.size()) return false;
+        position_ = static_cast<std::size_t>(position);
+        return true;
+    }
+
+   private:
+    D distribution_;
+    RandomStream stream_;
+    std::vector<double> samples_;
+    std::size_t position_;
 };
 
 }  // namespace sim
@@ -19,37 +19,59 @@ struct Quote {
     const Ticks& bestBid() const;
     const Ticks& bestAsk() const;
 
+    // Level of the first valid (non-zero) price on each side, 0 if there is none
+    std::size_t bestBidLevel() const;
+    std::size_t bestAskLevel() const;
+
+    // Bounds checked, throw std::out_of_range for priceLevel >= depth
     const Ticks& getBid(std::size_t priceLevel) const;
     const Ticks& getAsk(std::size_t priceLevel) const;
     const Ticks& getBidSize(std::size_t priceLevel) const;
     const Ticks& getAskSize(std::size_t priceLevel) const;
 
-    std::array<Ticks, depth> getBids() const;
-    std::array<Ticks, depth> getAsks() const;
-    std::array<Ticks, depth> getBidSizes() const;
-    std::array<Ticks, depth> getAskSizes() const;
+    // Unchecked, for the matching hot path; priceLevel must be below depth
+    const Ticks& bid(std::size_t priceLevel) const { return prices[priceLevel]; }
+    const Ticks& ask(std::size_t priceLevel) const { return prices[depth + priceLevel]; }
+    const Ticks& bidSize(std::size_t priceLevel) const { return sizes[priceLevel]; }
+    const Ticks& askSize(std::size_t priceLevel) const { return sizes[depth + priceLevel]; }
+
+    // Views of each side's ladder, best level first, valid as long as the quote is
+    std::span<const Ticks, depth> getBids() const;
+    std::span<const Ticks, depth> getAsks() const;
+    std::span<const Ticks, depth> getBidSizes() const;
+    std::span<const Ticks, depth> getAskSizes() const;
 };
 
 template <std::size_t depth>
-inline const Ticks& Quote<depth>::bestBid() const {
+inline std::size_t Quote<depth>::bestBidLevel() const {
     // Find first valid (non-zero) bid price
     for (std::size_t i = 0; i < depth; ++i) {
         if (prices[i].value() > 0) {
-            return prices[i];
+            return i;
         }
     }
-    return prices[0];  // Return first level if all are invalid
+    return 0;  // Return first level if all are invalid
 }
 
 template <std::size_t depth>
-inline const Ticks& Quote<depth>::bestAsk() const {
+inline std::size_t Quote<depth>::bestAskLevel() const {
     // Find first valid (non-zero) ask price
     for (std::size_t i = 0; i < depth; ++i) {
         if (prices[depth + i].value() > 0) {
-            return prices[depth + i];
+            return i;
         }
     }
-    return prices[depth];  // Return first level if all are invalid
+    return 0;  // Return first level if all are invalid
+}
+
+template <std::size_t depth>
+inline const Ticks& Quote<depth>::bestBid() const {
+    return prices[bestBidLevel()];
+}
+
+template <std::size_t depth>
+inline const Ticks& Quote<depth>::bestAsk() const {
+    return prices[depth + bestAskLevel()];
 }
 
 template <std::size_t depth>
@@ -85,39 +107,23 @@ inline const Ticks& Quote<depth>::getAskSize(std::size_t priceLevel) const {
 }
 
 template <std::size_t depth>
-inline std::array<Ticks, depth> Quote<depth>::getBids() const {
-    std::array<Ticks, depth> bids;
-    for (std::size_t i = 0; i < depth; ++i) {
-        bids[i] = prices[i];
-    }
-    return bids;
+inline std::span<const Ticks, depth> Quote<depth>::getBids() const {
+    return std::span<const Ticks, 2 * depth>(prices).template first<depth>();
 }
 
 template <std::size_t depth>
-inline std::array<Ticks, depth> Quote<depth>::getAsks() const {
-    std::array<Ticks, depth> asks;
-    for (std::size_t i = 0; i < depth; ++i) {
-        asks[i] = prices[depth + i];
-    }
-    return asks;
+inline std::span<const Ticks, depth> Quote<depth>::getAsks() const {
+    return std::span<const Ticks, 2 * depth>(prices).template last<depth>();
 }
 
 template <std::size_t depth>
-inline std::array<Ticks, depth> Quote<depth>::getBidSizes() const {
-    std::array<Ticks, depth> bidSizes;
-    for (std::size_t i = 0; i < depth; ++i) {
-        bidSizes[i] = sizes[i];
-    }
-    return bidSizes;
+inline std::span<const Ticks, depth> Quote<depth>::getBidSizes() const {
+    return std::span<const Ticks, 2 * depth>(sizes).template first<depth>();
 }
 
 template <std::size_t depth>
-inline std::array<Ticks, depth> Quote<depth>::getAskSizes() const {
-    std::array<Ticks, depth> askSizes;
-    for (std::size_t i = 0; i < depth; ++i) {
-        askSizes[i] = prices[depth + i];
-    }
-    return askSizes;
+inline std::span<const Ticks, depth> Quote<depth>::getAskSizes() const {
+    return std::span<const Ticks, 2 * depth>(sizes).template last<depth>();
 }
 
 template struct Quote<10>;
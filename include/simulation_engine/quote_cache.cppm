@@ -0,0 +1,127 @@
+// quote_cache.cppm
+export module simulation_engine:quote_cache;
+
+import :quote;
+import :types;
+import :market_data;
+import :run_params;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief Identity of the source file a quote cache was built from
+ * @details A cache file is only used when every field matches the source it is opened for, so
+ * an edited source file or a different depth or symbol filter transparently rebuilds the cache.
+ */
+struct QuoteCacheKey {
+    std::uint64_t sourcePathHash{0};
+    std::int64_t sourceModifiedTime{0};
+    std::uint64_t sourceSize{0};
+    std::uint64_t symbolFilterHash{0};
+    std::uint32_t depth{0};
+    std::uint32_t quoteSize{0};
+};
+
+/**
+ * @brief Build the cache key of a source file as it is on disk now.
+ * @param sourcePath Path to the Parquet source file.
+ * @param params Market data parameters; the symbol filter changes the cached contents.
+ * @param key Receives the key.
+ * @return False if the source file cannot be inspected.
+ */
+template <std::size_t depth>
+bool makeQuoteCacheKey(const std::string& sourcePath,
+    const MarketDataParams& params,
+    QuoteCacheKey& key);
+
+/**
+ * @brief Location of the cache file for a source file.
+ */
+template <std::size_t depth>
+std::string quoteCachePath(const std::string& sourcePath, const MarketDataParams& params);
+
+/**
+ * @brief Persist a filtered quote stream as a cache file.
+ * @details Writes to a temporary file and renames it into place, so concurrent runs never map a
+ * partially written cache.
+ * @return False if the cache could not be written.
+ */
+template <std::size_t depth>
+bool writeQuoteCache(const std::string& cachePath,
+    const QuoteCacheKey& key,
+    std::span<const Quote<depth>> quotes);
+
+/**
+ * @brief Read-only memory mapping of a quote cache file
+ * @details
+ * The quotes are stored exactly as Quote<depth> is laid out in memory, so the mapping is served
+ * to the engine without decoding or copying. Pages are shared through the OS page cache, which
+ * lets concurrent runs on the same machine reuse one copy of the data.
+ */
+template <std::size_t depth>
+class MappedQuoteFile {
+   public:
+    MappedQuoteFile() = default;
+    ~MappedQuoteFile();
+
+    MappedQuoteFile(const MappedQuoteFile&) = delete;
+    MappedQuoteFile& operator=(const MappedQuoteFile&) = delete;
+    MappedQuoteFile(MappedQuoteFile&& other) noexcept;
+    MappedQuoteFile& operator=(MappedQuoteFile&& other) noexcept;
+
+    /**
+     * @brief Map a cache file if its header matches the expected key.
+     * @return False if the file is missing, truncated, or was built from a different source.
+     */
+    bool open(const std::string& cachePath, const QuoteCacheKey& key);
+    void close();
+
+    bool isOpen() const { return address_ != nullptr; }
+    std::span<const Quote<depth>> quotes() const { return quotes_; }
+
+   private:
+    void* address_{nullptr};
+    std::size_t length_{0};
+    std::span<const Quote<depth>> quotes_;
+};
+
+/**
+ * @brief Market data served from memory-mapped quote caches
+ * @details
+ * The first time a Parquet file is loaded it is decoded and filtered as usual and the resulting
+ * quote stream is written to MarketDataParams::quoteCacheDirectory. Every later load maps that
+ * cache instead, so startup costs only the page faults for the quotes that are actually read.
+ * If the cache cannot be written the decoded quotes are served from memory for this run.
+ */
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+class MarketDataQuoteCache : public IMarketData<depth, numberOfSymbols> {
+   public:
+    MarketDataQuoteCache(const std::string& marketDataFilePath,
+        const MarketDataParams& params = {})
+        : IMarketData<depth, numberOfSymbols>(marketDataFilePath, false, params) {
+        loadData(marketDataFilePath);
+        this->refreshQuoteView();
+    }
+
+    MarketDataQuoteCache(const std::vector<std::string>& marketDataFilePaths,
+        const MarketDataParams& params = {})
+        : IMarketData<depth, numberOfSymbols>(marketDataFilePaths, true, params) {
+        this->loadFile(0);
+    }
+
+   protected:
+    bool loadData() override;
+    bool loadData(const std::string& marketDataFilePath) override;
+
+    std::optional<std::span<const Quote<depth>>> externalQuotes() const override {
+        if (!mappedFile_.isOpen()) return std::nullopt;
+        return mappedFile_.quotes();
+    }
+
+   private:
+    MappedQuoteFile<depth> mappedFile_;
+};
+
+}  // namespace sim
@@ -0,0 +1,447 @@
+// quote_store.cppm
+export module simulation_engine:quote_store;
+
+import :quote;
+import :types;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief Struct-of-arrays storage for a quote stream
+ * @details
+ * Keeps every field of Quote<depth> in its own contiguous column: timestamps, symbol ids, and
+ * one price and one size column per book level and side. A scan that only needs the timestamp,
+ * the symbol and the top few levels reads just those columns instead of pulling every
+ * ~336 byte row through the cache.
+ *
+ * Row i of the stream is spread over index i of every column; load() gathers it back into a
+ * Quote<depth> when the full book is needed.
+ */
+template <std::size_t depth>
+struct ColumnarQuotes {
+    std::vector<TimeStamp> timestamps;
+    std::vector<std::uint16_t> symbolIds;
+    std::array<std::vector<Ticks>, depth> bidPrices;
+    std::array<std::vector<Ticks>, depth> askPrices;
+    std::array<std::vector<Ticks>, depth> bidSizes;
+    std::array<std::vector<Ticks>, depth> askSizes;
+
+    std::size_t size() const { return timestamps.size(); }
+    bool empty() const { return timestamps.empty(); }
+
+    void clear();
+    void reserve(std::size_t numberOfQuotes);
+    void push_back(const Quote<depth>& quote);
+
+    /**
+     * @brief Replace the contents with a row-oriented quote stream.
+     */
+    void assign(std::span<const Quote<depth>> quotes);
+
+    /**
+     * @brief Add a row-oriented quote stream after the rows already held.
+     */
+    void append(std::span<const Quote<depth>> quotes);
+
+    /**
+     * @brief Gather row index back into a full quote.
+     * @param index Row of the stream; must be less than size().
+     * @param out Quote that receives the row.
+     */
+    void load(std::size_t index, Quote<depth>& out) const;
+
+    /**
+     * @brief Approximate number of bytes held by the columns.
+     */
+    std::size_t memoryUsage() const;
+};
+
+template <std::size_t depth>
+inline void ColumnarQuotes<depth>::clear() {
+    timestamps.clear();
+    symbolIds.clear();
+    for (std::size_t level = 0; level < depth; ++level) {
+        bidPrices[level].clear();
+        askPrices[level].clear();
+        bidSizes[level].clear();
+        askSizes[level].clear();
+    }
+}
+
+template <std::size_t depth>
+inline void ColumnarQuotes<depth>::reserve(std::size_t numberOfQuotes) {
+    timestamps.reserve(numberOfQuotes);
+    symbolIds.reserve(numberOfQuotes);
+    for (std::size_t level = 0; level < depth; ++level) {
+        bidPrices[level].reserve(numberOfQuotes);
+        askPrices[level].reserve(numberOfQuotes);
+        bidSizes[level].reserve(numberOfQuotes);
+        askSizes[level].reserve(numberOfQuotes);
+    }
+}
+
+template <std::size_t depth>
+inline void ColumnarQuotes<depth>::push_back(const Quote<depth>& quote) {
+    timestamps.push_back(quote.timestamp);
+    symbolIds.push_back(static_cast<std::uint16_t>(quote.symbolId));
+    for (std::size_t level = 0; level < depth; ++level) {
+        bidPrices[level].push_back(quote.prices[level]);
+        askPrices[level].push_back(quote.prices[depth + level]);
+        bidSizes[level].push_back(quote.sizes[level]);
+        askSizes[level].push_back(quote.sizes[depth + level]);
+    }
+}
+
+template <std::size_t depth>
+inline void ColumnarQuotes<depth>::assign(std::span<const Quote<depth>> quotes) {
+    clear();
+    append(quotes);
+}
+
+template <std::size_t depth>
+inline void ColumnarQuotes<depth>::append(std::span<const Quote<depth>> quotes) {
+    const std::size_t first = size();
+    const std::size_t numberOfQuotes = first + quotes.size();
+    timestamps.resize(numberOfQuotes);
+    symbolIds.resize(numberOfQuotes);
+    for (std::size_t i = 0; i < quotes.size(); ++i) {
+        timestamps[first + i] = quotes[i].timestamp;
+        symbolIds[first + i] = static_cast<std::uint16_t>(quotes[i].symbolId);
+    }
+
+    // Fill one column at a time so each pass writes a single sequential stream
+    for (std::size_t level = 0; level < depth; ++level) {
+        bidPrices[level].resize(numberOfQuotes);
+        askPrices[level].resize(numberOfQuotes);
+        bidSizes[level].resize(numberOfQuotes);
+        askSizes[level].resize(numberOfQuotes);
+        for (std::size_t i = 0; i < quotes.size(); ++i) {
+            bidPrices[level][first + i] = quotes[i].prices[level];
+            askPrices[level][first + i] = quotes[i].prices[depth + level];
+            bidSizes[level][first + i] = quotes[i].sizes[level];
+            askSizes[level][first + i] = quotes[i].sizes[depth + level];
+        }
+    }
+}
+
+template <std::size_t depth>
+inline void ColumnarQuotes<depth>::load(std::size_t index, Quote<depth>& out) const {
+    out.timestamp = timestamps[index];
+    out.symbolId = symbolIds[index];
+    for (std::size_t level = 0; level < depth; ++level) {
+        out.prices[level] = bidPrices[level][index];
+        out.prices[depth + level] = askPrices[level][index];
+        out.sizes[level] = bidSizes[level][index];
+        out.sizes[depth + level] = askSizes[level][index];
+    }
+}
+
+template <std::size_t depth>
+inline std::size_t ColumnarQuotes<depth>::memoryUsage() const {
+    return size() * (sizeof(TimeStamp) + sizeof(std::uint16_t) + 4 * depth * sizeof(Ticks));
+}
+
+/**
+ * @brief One quote in the compact encoding
+ * @details Prices are signed 32-bit offsets from the reference price of the block the row
+ * belongs to, sizes are 32-bit like the source columns, and the timestamp is a 32-bit offset
+ * from the block's base timestamp. For depth 10 this is 168 bytes against 336 for Quote<10>.
+ */
+template <std::size_t depth>
+struct CompactQuote {
+    std::uint32_t timestampOffset{0};
+    std::uint16_t symbolId{0};
+    std::array<std::int32_t, 2 * depth> priceOffsets{};
+    std::array<std::uint32_t, 2 * depth> sizes{};
+};
+
+/**
+ * @brief Compact storage for a quote stream
+ * @details
+ * Rows are grouped into blocks that share a reference price and a base timestamp. A new block
+ * starts whenever a row cannot be expressed relative to the current one: a price more than
+ * 2^31 ticks away, a timestamp more than ~4.29 seconds later, or an earlier timestamp. Blocks
+ * are therefore rare and the per-row cost stays at sizeof(CompactQuote<depth>).
+ *
+ * Empty price levels (price 0) are stored as a sentinel so they decode back to exactly 0 no
+ * matter how far the reference price is from zero. Values are widened back to Ticks by load().
+ */
+template <std::size_t depth>
+class CompactQuotes {
+   public:
+    std::size_t size() const { return rows_.size(); }
+    bool empty() const { return rows_.empty(); }
+
+    void clear();
+    void reserve(std::size_t numberOfQuotes) { rows_.reserve(numberOfQuotes); }
+    void push_back(const Quote<depth>& quote);
+
+    /**
+     * @brief Replace the contents with a row-oriented quote stream.
+     */
+    void assign(std::span<const Quote<depth>> quotes);
+
+    /**
+     * @brief Add a row-oriented quote stream after the rows already held.
+     */
+    void append(std::span<const Quote<depth>> quotes);
+
+    /**
+     * @brief Decode row index into a full-width quote.
+     * @details Constant time when rows are read in order; otherwise the block is found with a
+     * binary search.
+     */
+    void load(std::size_t index, Quote<depth>& out) const;
+
+    std::uint16_t symbolId(std::size_t index) const { return rows_[index].symbolId; }
+
+    TimeStamp timestamp(std::size_t index) const {
+        return TimeStamp{blockFor(index).baseTimestamp.value() + rows_[index].timestampOffset};
+    }
+
+    /**
+     * @brief Approximate number of bytes held by the rows and block headers.
+     */
+    std::size_t memoryUsage() const {
+        return rows_.size() * sizeof(CompactQuote<depth>) + blocks_.size() * sizeof(Block);
+    }
+
+   private:
+    struct Block {
+        std::size_t firstIndex;
+        TimeStamp baseTimestamp;
+        Ticks referencePrice;
+    };
+
+    static constexpr std::int32_t kEmptyPrice = std::numeric_limits<std::int32_t>::min();
+
+    bool fitsCurrentBlock(const Quote<depth>& quote) const;
+    const Block& blockFor(std::size_t index) const;
+
+    std::vector<CompactQuote<depth>> rows_;
+    std::vector<Block> blocks_;
+    mutable std::size_t cursorBlock_{0};  // Block of the last row decoded
+};
+
+template <std::size_t depth>
+inline void CompactQuotes<depth>::clear() {
+    rows_.clear();
+    blocks_.clear();
+    cursorBlock_ = 0;
+}
+
+template <std::size_t depth>
+inline bool CompactQuotes<depth>::fitsCurrentBlock(const Quote<depth>& quote) const {
+    if (blocks_.empty()) return false;
+
+    const Block& block = blocks_.back();
+    if (quote.timestamp < block.baseTimestamp ||
+        quote.timestamp.value() - block.baseTimestamp.value() >
+            std::numeric_limits<std::uint32_t>::max()) {
+        return false;
+    }
+
+    for (const Ticks& price : quote.prices) {
+        if (price.value() == 0) continue;
+        const std::int64_t offset = price.value() - block.referencePrice.value();
+        if (offset <= kEmptyPrice || offset > std::numeric_limits<std::int32_t>::max()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t depth>
+inline void CompactQuotes<depth>::push_back(const Quote<depth>& quote) {
+    if (!fitsCurrentBlock(quote)) {
+        // Anchor the new block on the first populated level so its neighbours stay close
+        Ticks referencePrice{0};
+        for (const Ticks& price : quote.prices) {
+            if (price.value() != 0) {
+                referencePrice = price;
+                break;
+            }
+        }
+        blocks_.push_back(Block{rows_.size(), quote.timestamp, referencePrice});
+    }
+
+    const Block& block = blocks_.back();
+    CompactQuote<depth>& row = rows_.emplace_back();
+    row.timestampOffset =
+        static_cast<std::uint32_t>(quote.timestamp.value() - block.baseTimestamp.value());
+    row.symbolId = static_cast<std::uint16_t>(quote.symbolId);
+    for (std::size_t slot = 0; slot < 2 * depth; ++slot) {
+        const std::int64_t price = quote.prices[slot].value();
+        row.priceOffsets[slot] = (price == 0)
+            ? kEmptyPrice
+            : static_cast<std::int32_t>(price - block.referencePrice.value());
+        // Source sizes are 32-bit, so this only saturates on corrupt input
+        row.sizes[slot] = static_cast<std::uint32_t>(std::clamp<std::int64_t>(
+            quote.sizes[slot].value(), 0, std::numeric_limits<std::uint32_t>::max()));
+    }
+}
+
+template <std::size_t depth>
+inline void CompactQuotes<depth>::assign(std::span<const Quote<depth>> quotes) {
+    clear();
+    append(quotes);
+}
+
+template <std::size_t depth>
+inline void CompactQuotes<depth>::append(std::span<const Quote<depth>> quotes) {
+    rows_.reserve(rows_.size() + quotes.size());
+    for (const Quote<depth>& quote : quotes) {
+        push_back(quote);
+    }
+}
+
+template <std::size_t depth>
+inline const typename CompactQuotes<depth>::Block& CompactQuotes<depth>::blockFor(
+    std::size_t index) const {
+    // Sequential reads stay in the cursor's block or step into the next one
+    if (cursorBlock_ >= blocks_.size() || index < blocks_[cursorBlock_].firstIndex) {
+        cursorBlock_ = 0;
+    }
+    if (cursorBlock_ + 1 < blocks_.size() && index >= blocks_[cursorBlock_ + 1].firstIndex) {
+        ++cursorBlock_;
+        if (cursorBlock_ + 1 < blocks_.size() && index >= blocks_[cursorBlock_ + 1].firstIndex) {
+            auto next = std::upper_bound(blocks_.begin() + cursorBlock_, blocks_.end(), index,
+                [](std::size_t value, const Block& block) { return value < block.firstIndex; });
+            cursorBlock_ = static_cast<std::size_t>(next - blocks_.begin()) - 1;
+        }
+    }
+    return blocks_[cursorBlock_];
+}
+
+template <std::size_t depth>
+inline void CompactQuotes<depth>::load(std::size_t index, Quote<depth>& out) const {
+    const Block& block = blockFor(index);
+    const CompactQuote<depth>& row = rows_[index];
+
+    out.timestamp = TimeStamp{block.baseTimestamp.value() + row.timestampOffset};
+    out.symbolId = row.symbolId;
+    for (std::size_t slot = 0; slot < 2 * depth; ++slot) {
+        const std::int32_t offset = row.priceOffsets[slot];
+        out.prices[slot] =
+            Ticks{(offset == kEmptyPrice) ? 0 : block.referencePrice.value() + offset};
+        out.sizes[slot] = Ticks{static_cast<std::int64_t>(row.sizes[slot])};
+    }
+}
+
+/**
+ * @brief A quote stream held in one QuoteLayout, the buffer market data is decoded into
+ * @details
+ * Decoders append quotes a batch at a time and the buffer encodes each batch into its layout as
+ * it arrives, so a file bound for the columnar or compact layout never exists as full-width rows
+ * beyond the batch being appended. clear() keeps the capacity of every column, so a buffer
+ * refilled batch after batch or file after file stops allocating once it has grown.
+ */
+template <std::size_t depth>
+class QuoteBuffer {
+   public:
+    explicit QuoteBuffer(QuoteLayout layout = QuoteLayout::Rows) : layout_(layout) {}
+
+    QuoteLayout layout() const { return layout_; }
+
+    std::size_t size() const {
+        switch (layout_) {
+            case QuoteLayout::Columns:
+                return columns_.size();
+            case QuoteLayout::Compact:
+                return compact_.size();
+            case QuoteLayout::Rows:
+                break;
+        }
+        return rows_.size();
+    }
+    bool empty() const { return size() == 0; }
+
+    void clear() {
+        rows_.clear();
+        columns_.clear();
+        compact_.clear();
+    }
+
+    void reserve(std::size_t numberOfQuotes) {
+        switch (layout_) {
+            case QuoteLayout::Columns:
+                columns_.reserve(numberOfQuotes);
+                return;
+            case QuoteLayout::Compact:
+                compact_.reserve(numberOfQuotes);
+                return;
+            case QuoteLayout::Rows:
+                rows_.reserve(numberOfQuotes);
+                return;
+        }
+    }
+
+    void push_back(const Quote<depth>& quote) {
+        switch (layout_) {
+            case QuoteLayout::Columns:
+                columns_.push_back(quote);
+                return;
+            case QuoteLayout::Compact:
+                compact_.push_back(quote);
+                return;
+            case QuoteLayout::Rows:
+                rows_.push_back(quote);
+                return;
+        }
+    }
+
+    void append(std::span<const Quote<depth>> quotes) {
+        switch (layout_) {
+            case QuoteLayout::Columns:
+                columns_.append(quotes);
+                return;
+            case QuoteLayout::Compact:
+                compact_.append(quotes);
+                return;
+            case QuoteLayout::Rows:
+                rows_.insert(rows_.end(), quotes.begin(), quotes.end());
+                return;
+        }
+    }
+
+    void assign(std::span<const Quote<depth>> quotes) {
+        clear();
+        append(quotes);
+    }
+
+    /**
+     * @brief Replace the contents with decoded rows, which the row layout adopts without a copy.
+     */
+    void assign(std::vector<Quote<depth>>&& quotes) {
+        if (layout_ == QuoteLayout::Rows) {
+            rows_ = std::move(quotes);
+            return;
+        }
+        assign(std::span<const Quote<depth>>(quotes));
+    }
+
+    /**
+     * @brief The rows of the row layout, which decoders may write to directly; empty otherwise.
+     */
+    std::vector<Quote<depth>>& rows() { return rows_; }
+    const std::vector<Quote<depth>>& rows() const { return rows_; }
+    const ColumnarQuotes<depth>& columns() const { return columns_; }
+    const CompactQuotes<depth>& compact() const { return compact_; }
+
+   private:
+    QuoteLayout layout_;
+    std::vector<Quote<depth>> rows_;
+    ColumnarQuotes<depth> columns_;
+    CompactQuotes<depth> compact_;
+};
+
+template struct ColumnarQuotes<10>;
+template struct CompactQuote<10>;
+template class CompactQuotes<10>;
+template class QuoteBuffer<10>;
+
+static_assert(2 * sizeof(CompactQuote<10>) <= sizeof(Quote<10>));
+
+}  // namespace sim
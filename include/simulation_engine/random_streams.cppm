@@ -0,0 +1,202 @@
+// random_streams.cppm
+export module simulation_engine:random_streams;
+
+import std;
+
+export namespace sim {
+
+using PhiloxCounter = std::array<std::uint32_t, 4>;
+using PhiloxKey = std::array<std::uint32_t, 2>;
+
+/**
+ * @brief The Philox4x32-10 block function
+ * @details
+ * Maps a 128-bit counter and a 64-bit key to 128 random bits (Salmon et al., "Parallel Random
+ * Numbers: As Easy as 1, 2, 3", SC11). There is no state besides the counter, so any draw can be
+ * computed directly from where it sits in the stream rather than by advancing a generator to it.
+ */
+constexpr PhiloxCounter philox4x32(PhiloxCounter counter, PhiloxKey key) {
+    constexpr std::uint32_t multiplier0 = 0xD2511F53;
+    constexpr std::uint32_t multiplier1 = 0xCD9E8D57;
+    constexpr std::uint32_t keyIncrement0 = 0x9E3779B9;
+    constexpr std::uint32_t keyIncrement1 = 0xBB67AE85;
+
+    for (int round = 0; round < 10; ++round) {
+        const std::uint64_t product0 = std::uint64_t{multiplier0} * counter[0];
+        const std::uint64_t product1 = std::uint64_t{multiplier1} * counter[2];
+        counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+            static_cast<std::uint32_t>(product1),
+            static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+            static_cast<std::uint32_t>(product0)};
+        key[0] += keyIncrement0;
+        key[1] += keyIncrement1;
+    }
+    return counter;
+}
+
+// Key slots past the 16-bit symbol range, for streams that do not belong to a symbol
+inline constexpr std::uint32_t kSendLatencyStreamKey = 0x10000;
+inline constexpr std::uint32_t kReceiveLatencyStreamKey = 0x10001;
+
+/**
+ * @brief The key of the streams of one (seed, trial, symbol).
+ * @details Derived by encrypting (trial, symbol) under the seed, so neighbouring trials and
+ * symbols get unrelated keys. symbol may also be one of the slots above.
+ */
+constexpr PhiloxKey deriveStreamKey(std::uint64_t seed,
+    std::uint64_t trial,
+    std::uint32_t symbol) {
+    const PhiloxCounter block = philox4x32(
+        {static_cast<std::uint32_t>(trial), static_cast<std::uint32_t>(trial >> 32), symbol, 0},
+        {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)});
+    return {block[0], block[1]};
+}
+
+/**
+ * @brief Convert two random words to a double uniform on [0, 1) with 53 random bits.
+ */
+constexpr double uniformFromWords(std::uint32_t high, std::uint32_t low) {
+    const std::uint64_t bits = (std::uint64_t{high} << 21) ^ (low >> 11);
+    return static_cast<double>(bits) * 0x1.0p-53;
+}
+
+/**
+ * @brief A counter-based random stream
+ * @details
+ * Identified by a key and a (stream, substream) pair; block b of the stream is
+ * philox4x32({b, substream, stream low, stream high}, key). A stream is a few dozen bytes and
+ * costs nothing to create, unlike the 5 KB state of std::mt19937, so one can be made for every
+ * draw site, e.g. per order and fill attempt. Its values depend only on that identity, not on
+ * which thread ran it or what was drawn before.
+ *
+ * Satisfies std::uniform_random_bit_generator, so it plugs into the standard distributions.
+ * fill and fillUniform generate many draws at once, several blocks per pass so the compiler can
+ * vectorize the rounds.
+ */
+class RandomStream {
+   public:
+    using result_type = std::uint32_t;
+
+    constexpr RandomStream(PhiloxKey key, std::uint64_t stream, std::uint32_t substream = 0)
+        : key_{key},
+          substream_{substream},
+          streamLow_{static_cast<std::uint32_t>(stream)},
+          streamHigh_{static_cast<std::uint32_t>(stream >> 32)} {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    constexpr result_type operator()() {
+        if (position_ == buffer_.size()) {
+            buffer_ = philox4x32(counterOf(nextBlock_++), key_);
+            position_ = 0;
+        }
+        return buffer_[position_++];
+    }
+
+    /**
+     * @brief The next two words as a double uniform on [0, 1), the same as fillUniform draws.
+     */
+    constexpr double uniform() {
+        const std::uint32_t high = (*this)();
+        const std::uint32_t low = (*this)();
+        return uniformFromWords(high, low);
+    }
+
+    /**
+     * @brief Fill out with the next out.size() words of the stream.
+     */
+    void fill(std::span<std::uint32_t> out) {
+        std::size_t written = 0;
+        // Use up the words left over from the last block first
+        while (written < out.size() && position_ != buffer_.size()) {
+            out[written++] = buffer_[position_++];
+        }
+
+        const std::size_t fullBlocks = (out.size() - written) / 4;
+        generateBlocks(out.subspan(written, fullBlocks * 4));
+        written += fullBlocks * 4;
+
+        while (written < out.size()) out[written++] = (*this)();
+    }
+
+    /**
+     * @brief Fill out with doubles uniform on [0, 1), two words of the stream each.
+     */
+    void fillUniform(std::span<double> out) {
+        constexpr std::size_t chunk = 128;
+        std::array<std::uint32_t, 2 * chunk> words;
+        for (std::size_t begin = 0; begin < out.size(); begin += chunk) {
+            const std::size_t count = std::min(chunk, out.size() - begin);
+            fill(std::span<std::uint32_t>{words.data(), 2 * count});
+            for (std::size_t i = 0; i < count; ++i) {
+                out[begin + i] = uniformFromWords(words[2 * i], words[2 * i + 1]);
+            }
+        }
+    }
+
+   private:
+    static constexpr std::size_t kBlocksPerPass = 16;
+
+    constexpr PhiloxCounter counterOf(std::uint32_t block) const {
+        return {block, substream_, streamLow_, streamHigh_};
+    }
+
+    // Whole blocks straight into out, whose size is a multiple of four
+    void generateBlocks(std::span<std::uint32_t> out) {
+        const std::size_t numberOfBlocks = out.size() / 4;
+        std::size_t block = 0;
+
+        // Lane-major copies of kBlocksPerPass counters, so each round is the same few operations
+        // over independent lanes
+        for (; block + kBlocksPerPass <= numberOfBlocks; block += kBlocksPerPass) {
+            std::array<std::uint32_t, kBlocksPerPass> x0, x1, x2, x3;
+            for (std::size_t lane = 0; lane < kBlocksPerPass; ++lane) {
+                x0[lane] = nextBlock_ + static_cast<std::uint32_t>(lane);
+                x1[lane] = substream_;
+                x2[lane] = streamLow_;
+                x3[lane] = streamHigh_;
+            }
+            PhiloxKey key = key_;
+            for (int round = 0; round < 10; ++round) {
+                for (std::size_t lane = 0; lane < kBlocksPerPass; ++lane) {
+                    const std::uint64_t product0 = std::uint64_t{0xD2511F53} * x0[lane];
+                    const std::uint64_t product1 = std::uint64_t{0xCD9E8D57} * x2[lane];
+                    const std::uint32_t y0 =
+                        static_cast<std::uint32_t>(product1 >> 32) ^ x1[lane] ^ key[0];
+                    const std::uint32_t y2 =
+                        static_cast<std::uint32_t>(product0 >> 32) ^ x3[lane] ^ key[1];
+                    x1[lane] = static_cast<std::uint32_t>(product1);
+                    x3[lane] = static_cast<std::uint32_t>(product0);
+                    x0[lane] = y0;
+                    x2[lane] = y2;
+                }
+                key[0] += 0x9E3779B9;
+                key[1] += 0xBB67AE85;
+            }
+            for (std::size_t lane = 0; lane < kBlocksPerPass; ++lane) {
+                const std::size_t offset = 4 * (block + lane);
+                out[offset] = x0[lane];
+                out[offset + 1] = x1[lane];
+                out[offset + 2] = x2[lane];
+                out[offset + 3] = x3[lane];
+            }
+            nextBlock_ += kBlocksPerPass;
+        }
+
+        for (; block < numberOfBlocks; ++block) {
+            const PhiloxCounter words = philox4x32(counterOf(nextBlock_++), key_);
+            std::ranges::copy(words, out.begin() + 4 * block);
+        }
+    }
+
+    PhiloxKey key_;
+    std::uint32_t substream_;
+    std::uint32_t streamLow_;
+    std::uint32_t streamHigh_;
+    std::uint32_t nextBlock_{0};
+    PhiloxCounter buffer_{};
+    std::size_t position_{4};
+};
+
+}  // namespace sim
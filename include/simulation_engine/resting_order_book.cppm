@@ -0,0 +1,123 @@
+// resting_order_book.cppm
+export module simulation_engine:resting_order_book;
+
+import :order_placement;
+import :types;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief Price index of the orders working at the exchange, per symbol
+ * @details
+ * Limit buys are kept by descending price and limit sells by ascending price, each level in
+ * OrderId order, so the orders that can trade against a quote are a prefix of their side. Market
+ * orders always can and are kept apart in OrderId order. The index only holds ids and prices; the
+ * orders themselves stay in the engine's PendingOrderStore.
+ */
+template <std::uint16_t numberOfSymbols>
+class RestingOrderBook {
+    struct Entry {
+        Ticks price;
+        std::uint64_t orderId;
+    };
+
+    // Highest price first, then time priority
+    struct BidOrder {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return (a.price != b.price) ? b.price < a.price : a.orderId < b.orderId;
+        }
+    };
+
+    // Lowest price first, then time priority
+    struct AskOrder {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return (a.price != b.price) ? a.price < b.price : a.orderId < b.orderId;
+        }
+    };
+
+    struct SymbolBook {
+        std::set<Entry, BidOrder> bids;
+        std::set<Entry, AskOrder> asks;
+        std::set<std::uint64_t> marketOrders;
+    };
+
+   public:
+    void add(const NewOrder& order);
+    void remove(const NewOrder& order);
+
+    /**
+     * @brief Append the ids of the orders on symbol that can trade against the given book.
+     * @details A limit buy can trade when its price reaches bestAsk and a limit sell when its
+     * price is at or below bestBid; market orders always can. Only those orders are visited.
+     * @param symbol The symbol whose quote changed.
+     * @param bestBid Price of the first bid level of the quote.
+     * @param bestAsk Price of the first ask level of the quote.
+     * @param out Receives the ids, in no particular order.
+     */
+    void collectMarketable(std::uint16_t symbol,
+        Ticks bestBid,
+        Ticks bestAsk,
+        std::vector<OrderId>& out) const;
+
+    std::size_t size() const;
+    void clear() { books_ = {}; }
+
+   private:
+    std::array<SymbolBook, numberOfSymbols> books_;
+};
+
+template <std::uint16_t numberOfSymbols>
+inline void RestingOrderBook<numberOfSymbols>::add(const NewOrder& order) {
+    SymbolBook& book = books_[order.symbol];
+    if (order.orderType == OrderType::Market) {
+        book.marketOrders.insert(order.id.value());
+    } else if (order.instruction == OrderInstruction::Buy) {
+        book.bids.insert({order.price, order.id.value()});
+    } else {
+        book.asks.insert({order.price, order.id.value()});
+    }
+}
+
+template <std::uint16_t numberOfSymbols>
+inline void RestingOrderBook<numberOfSymbols>::remove(const NewOrder& order) {
+    SymbolBook& book = books_[order.symbol];
+    if (order.orderType == OrderType::Market) {
+        book.marketOrders.erase(order.id.value());
+    } else if (order.instruction == OrderInstruction::Buy) {
+        book.bids.erase({order.price, order.id.value()});
+    } else {
+        book.asks.erase({order.price, order.id.value()});
+    }
+}
+
+template <std::uint16_t numberOfSymbols>
+inline void RestingOrderBook<numberOfSymbols>::collectMarketable(std::uint16_t symbol,
+    Ticks bestBid,
+    Ticks bestAsk,
+    std::vector<OrderId>& out) const {
+    const SymbolBook& book = books_[symbol];
+
+    for (std::uint64_t orderId : book.marketOrders) out.push_back(OrderId{orderId});
+
+    for (const Entry& entry : book.bids) {
+        if (entry.price < bestAsk) break;
+        out.push_back(OrderId{entry.orderId});
+    }
+    for (const Entry& entry : book.asks) {
+        if (bestBid < entry.price) break;
+        out.push_back(OrderId{entry.orderId});
+    }
+}
+
+template <std::uint16_t numberOfSymbols>
+inline std::size_t RestingOrderBook<numberOfSymbols>::size() const {
+    std::size_t total = 0;
+    for (const SymbolBook& book : books_) {
+        total += book.bids.size() + book.asks.size() + book.marketOrders.size();
+    }
+    return total;
+}
+
+}  // namespace sim
@@ -1,11 +1,53 @@
 export module simulation_engine:run_params;
 
+import :probability_distributions;
 import :types;
 
 import std;
 
 export namespace sim {
 
+/**
+ * @brief Configuration parameters for market data sources
+ * @details Controls how quote files are decoded into the engine's quote buffer. In streaming
+ * mode the file is decoded one bounded batch at a time so peak memory follows the budget below
+ * rather than the file size.
+ */
+struct MarketDataParams {
+    // Decode the file incrementally instead of loading it whole before the first quote
+    bool streaming{false};
+
+    // Layout of the buffered quotes. Columns favours scans over a few fields of many quotes,
+    // Compact halves the memory per quote
+    QuoteLayout layout{QuoteLayout::Rows};
+
+    // Symbols to load; rows for any other symbol are dropped at scan time. Empty loads every symbol
+    std::vector<std::uint16_t> symbolIds{};
+
+    // Upper bound on memory held by one batch (decoded Arrow columns plus the quote buffer)
+    std::size_t memoryBudgetBytes{64ULL * 1024 * 1024};  // 64 MiB
+
+    // Threads converting the rows of a single file to quotes; 1 decodes serially, 0 uses every
+    // hardware thread. Above 1, Arrow's column and row-group reads also run in parallel, on
+    // Arrow's process-wide CPU pool at whatever capacity the application set for it
+    std::size_t decodeThreads{1};
+
+    // Multi-file runs decode upcoming files in the background while the current one is consumed
+    std::size_t prefetchDepth{1};    // Files decoded ahead of the current one (0 disables)
+    std::size_t prefetchThreads{1};  // Background decoding threads
+
+    // IMarketData::seek() restores the nearest keyframe and replays from there. A keyframe is
+    // taken every keyframeIntervalNanoseconds of market time or every keyframeIntervalQuotes
+    // quotes, whichever comes first (0 disables either)
+    std::uint64_t keyframeIntervalNanoseconds{60ULL * 1'000'000'000};  // 1 minute
+    std::size_t keyframeIntervalQuotes{0};
+    bool persistKeyframes{true};  // Save keyframe indexes next to the quote caches for reuse
+
+    // Where MarketDataQuoteCache keeps decoded quote files. Empty uses a folder in the system
+    // temporary directory
+    std::string quoteCacheDirectory{};
+};
+
 /**
  * @brief Configuration parameters for simulation runs
  * @details Contains all configurable parameters for simulation execution including
@@ -22,6 +64,11 @@ struct RunParams {
     std::uint64_t sendLatencyNanoseconds{30'000'000};     // 30 milliseconds
     std::uint64_t receiveLatencyNanoseconds{30'000'000};  // 30 milliseconds
 
+    // Sampled latencies in nanoseconds, replacing the fixed ones above when set. Drawn in blocks
+    // from streams of fillRateSeed and trialIndex, like the fill rates
+    std::optional<AnyDistribution> sendLatencyDistribution{};
+    std::optional<AnyDistribution> receiveLatencyDistribution{};
+
     // Commissions
     // Ticks commissionPerShareMaker{0};
     // Ticks commissionPerShareTaker{0};
@@ -30,6 +77,12 @@ struct RunParams {
     Distribution buyFillRateDistribution;
     Distribution sellFillRateDistribution;
 
+    // Fill rates are drawn from counter-based streams keyed by (fillRateSeed, trialIndex, symbol,
+    // order id), so any trial can be replayed exactly. An empty seed draws one from
+    // std::random_device; the seed used is shown at DETAILED verbosity
+    std::optional<std::uint64_t> fillRateSeed{};
+    std::uint64_t trialIndex{0};
+
     // Strategy configuration
     std::string strategyName{"default"};
     std::string outputFile{"sim_results.csv"};
@@ -48,6 +101,9 @@ struct RunParams {
 
     // Statistics settings
     int statisticsUpdateRateSeconds;
+
+    // Market data loading
+    MarketDataParams marketData;
 };
 
 }  // namespace sim
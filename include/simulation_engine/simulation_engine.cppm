@@ -3,13 +3,25 @@ export module simulation_engine;
 
 export import :template_instantiations;
 export import :probability_distributions;
+export import :depth_kernels;
 export import :engine;
+export import :engine_policies;
+export import :event_queue;
+export import :ingest;
+export import :keyframe_index;
 export import :market_state;
 export import :market_data;
 export import :order_placement;
+export import :parameter_sweep;
+export import :pending_order_store;
 export import :portfolio;
 export import :quote;
+export import :quote_cache;
+export import :quote_store;
+export import :random_streams;
+export import :resting_order_book;
 export import :run_params;
+export import :snapshot;
 export import :statistics;
 export import :strategy_interface;
 export import :types;
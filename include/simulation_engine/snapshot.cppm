@@ -0,0 +1,142 @@
+// snapshot.cppm
+export module simulation_engine:snapshot;
+
+import std;
+
+export namespace sim {
+
+/**
+ * @brief Appends the state of simulation components to a byte buffer
+ * @details
+ * Values are written as their in-memory bytes, so only trivially copyable types can be written
+ * directly; vectors are written as their length followed by their elements. Components write
+ * their own state with a save(SnapshotWriter&) const member and read it back in the same order
+ * with load(SnapshotReader&). The bytes are only meant to be read by the same build.
+ */
+class SnapshotWriter {
+   public:
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write(const T& value) {
+        const auto* first = reinterpret_cast<const std::byte*>(&value);
+        bytes_.insert(bytes_.end(), first, first + sizeof(T));
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write(const std::vector<T>& values) {
+        write(static_cast<std::uint64_t>(values.size()));
+        const auto* first = reinterpret_cast<const std::byte*>(values.data());
+        bytes_.insert(bytes_.end(), first, first + values.size() * sizeof(T));
+    }
+
+    std::size_t size() const { return bytes_.size(); }
+
+    /**
+     * @brief Hand over everything written so far, leaving the writer empty.
+     */
+    std::vector<std::byte> release() { return std::exchange(bytes_, {}); }
+
+   private:
+    std::vector<std::byte> bytes_;
+};
+
+/**
+ * @brief Reads back what a SnapshotWriter wrote, in the same order
+ * @details Every read is bounds checked, so a truncated or foreign buffer makes a read return
+ * false instead of reading past its end.
+ */
+class SnapshotReader {
+   public:
+    explicit SnapshotReader(std::span<const std::byte> bytes) : bytes_(bytes) {}
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    bool read(T& value) {
+        if (bytes_.size() - position_ < sizeof(T)) return false;
+        std::memcpy(&value, bytes_.data() + position_, sizeof(T));
+        position_ += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    bool read(std::vector<T>& values) {
+        std::uint64_t size = 0;
+        if (!read(size) || size > (bytes_.size() - position_) / sizeof(T)) return false;
+        values.resize(static_cast<std::size_t>(size));
+        std::memcpy(values.data(), bytes_.data() + position_, values.size() * sizeof(T));
+        position_ += values.size() * sizeof(T);
+        return true;
+    }
+
+    /**
+     * @return True once every byte has been read.
+     */
+    bool atEnd() const { return position_ == bytes_.size(); }
+
+   private:
+    std::span<const std::byte> bytes_;
+    std::size_t position_{0};
+};
+
+// Bumped whenever the order or layout of the state in a snapshot changes
+inline constexpr std::uint32_t kSnapshotVersion = 2;
+inline constexpr std::array<char, 8> kSnapshotMagic{'S', 'I', 'M', 'S', 'N', 'A', 'P', 'S'};
+
+/**
+ * @brief First record of every engine snapshot
+ * @details Identifies the engine the snapshot was taken from, and the fill-rate seed and trial
+ * whose streams a restored run must keep drawing from.
+ */
+struct SnapshotHeader {
+    std::array<char, 8> magic{kSnapshotMagic};
+    std::uint32_t version{kSnapshotVersion};
+    std::uint32_t numberOfSymbols{0};
+    std::uint64_t depth{0};
+    std::uint64_t fillRateSeed{0};
+    std::uint64_t trialIndex{0};
+};
+
+/**
+ * @brief The complete state of a paused simulation
+ * @details
+ * Taken with Engine::snapshot and applied with Engine::restore, either to resume the run, e.g.
+ * after saving it to disk with saveSnapshot, or to start any number of branches from it. The
+ * bytes are immutable and shared between copies, so handing one snapshot to many branches
+ * copies nothing. Quotes are not part of a snapshot, only the position in them; a restored run
+ * needs market data over the same files.
+ */
+class EngineSnapshot {
+   public:
+    EngineSnapshot() = default;
+    explicit EngineSnapshot(std::vector<std::byte> bytes)
+        : bytes_{std::make_shared<const std::vector<std::byte>>(std::move(bytes))} {}
+
+    std::span<const std::byte> bytes() const {
+        return bytes_ ? std::span<const std::byte>{*bytes_} : std::span<const std::byte>{};
+    }
+
+    bool empty() const { return !bytes_ || bytes_->empty(); }
+    std::size_t size() const { return bytes_ ? bytes_->size() : 0; }
+
+   private:
+    std::shared_ptr<const std::vector<std::byte>> bytes_;
+};
+
+/**
+ * @brief Write a snapshot to a file.
+ * @details Written to a temporary file first and renamed into place, so a crash while saving
+ * leaves the previous snapshot at path intact.
+ * @return False if the file could not be written.
+ */
+bool saveSnapshot(const std::string& path, const EngineSnapshot& snapshot);
+
+/**
+ * @brief Read a snapshot written by saveSnapshot.
+ * @return False if the file cannot be read or does not start with a snapshot header of this
+ * version.
+ */
+bool loadSnapshot(const std::string& path, EngineSnapshot& snapshot);
+
+}  // namespace sim
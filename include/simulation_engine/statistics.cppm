@@ -6,10 +6,23 @@ import std;
 import :order_placement;
 import :portfolio;
 import :run_params;
+import :snapshot;
 import :types;
 
 export namespace sim {
 
+/**
+ * @brief Headline numbers of a finished run
+ */
+struct RunMetrics {
+    Ticks finalValue{0};
+    double totalReturn{0.0};
+    double maxDrawdown{0.0};
+    double volatility{0.0};
+    double sharpeRatio{0.0};
+    std::size_t fills{0};
+};
+
 template <typename Distribution>
 class RunningStatistics {
    public:
@@ -94,12 +107,28 @@ class Statistics {
 
     void outputSummary(std::ostream& outFile, VerbosityLevel verbosity);
 
+    /**
+     * @brief The headline numbers as of the last update.
+     */
+    RunMetrics metrics() const;
+
     void recordOrder(const NewOrder& order, TimeStamp timestamp);
     void recordFill(const Fill& fill);
     void updateStatistics(Ticks portfolioLiquidationValue);
 
     void updateInterestOwed(Ticks interestOwed);
 
+    /**
+     * @brief Write the accumulators and the order and fill histories to a snapshot.
+     */
+    void save(SnapshotWriter& out) const;
+
+    /**
+     * @brief Replace the accumulators and histories with ones written by save.
+     * @return False if the snapshot is truncated.
+     */
+    bool load(SnapshotReader& in);
+
    private:
     const RunParams<Distribution>& simulationParams_;
 
@@ -143,4 +172,66 @@ class Statistics {
     double calculateMaxDrawdownPercent() const;
 };
 
+/**
+ * @brief Spread of results over Monte Carlo trials of the fill model
+ * @details
+ * Collects the metrics of runs that replay the same strategy and data with independent fill-rate
+ * streams, and reports how much of a result is the strategy and how much is the luck of the
+ * fills. Trial i of a report used the stream seeded by (seed, i), so any trial, in particular the
+ * best and worst one, can be rerun on its own by setting RunParams::fillRateSeed and
+ * RunParams::trialIndex.
+ */
+class TrialStatistics {
+   public:
+    explicit TrialStatistics(std::uint64_t seed);
+
+    void add(std::uint64_t trialIndex, const RunMetrics& metrics);
+    void addFailure(std::uint64_t trialIndex, const std::string& error);
+
+    std::uint64_t seed() const { return seed_; }
+    std::size_t numberOfTrials() const { return trials_.size(); }
+    std::size_t numberOfFailures() const { return failures_.size(); }
+
+    /**
+     * @brief Metrics of a completed trial.
+     * @return Null if the trial was not added or failed.
+     */
+    const RunMetrics* find(std::uint64_t trialIndex) const;
+
+    void outputDetailed(std::ostream& out = std::cout) const;
+
+   private:
+    struct Trial {
+        std::uint64_t index;
+        RunMetrics metrics;
+    };
+
+    struct Failure {
+        std::uint64_t index;
+        std::string error;
+    };
+
+    // Distribution of one metric over the completed trials
+    struct Summary {
+        double mean{0.0};
+        double standardDeviation{0.0};
+        double minimum{0.0};
+        double percentile5{0.0};
+        double median{0.0};
+        double percentile95{0.0};
+        double maximum{0.0};
+    };
+
+    std::uint64_t seed_;
+    std::vector<Trial> trials_;
+    std::vector<Failure> failures_;
+
+    Summary summarize(double (*metric)(const RunMetrics&)) const;
+    void outputSummaryRow(std::ostream& out,
+        const std::string& name,
+        const Summary& summary,
+        double scale,
+        int precision) const;
+};
+
 }  // namespace sim
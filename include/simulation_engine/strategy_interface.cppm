@@ -4,8 +4,10 @@ export module simulation_engine:strategy_interface;
 import std;
 
 import :order_placement;
+import :pending_order_store;
 import :portfolio;
 import :quote;
+import :snapshot;
 import :types;
 import :market_state;
 
@@ -15,35 +17,40 @@ template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distributio
 class Engine;
 
 /**
- * @brief Interface for trading strategies
+ * @brief What every strategy shares: the engine connection, order API and bookkeeping
  * @details
- * Abstract base class that defines the contract for trading strategies.
- * Strategies implement specific trading logic and receive callbacks from
- * the simulation engine at key events during the simulation.
- *
- * The strategy interface provides a clean separation between trading logic
- * and simulation infrastructure. Strategies can focus on their specific
- * algorithms while the engine handles market data, order execution, and
- * portfolio management.
- *
- * Key strategy callbacks:
- * - onMarketData: Called when new market data arrives
- * - onFill: Called when orders are executed
- * - onEnd: Called at the end of simulation
+ * Holds the strategy's view of its portfolio and pending orders and places, cancels and replaces
+ * orders through the engine. It has no virtual functions; the callbacks are added either by
+ * IStrategy, whose virtual interface any engine entry point accepts, or directly by a concrete
+ * strategy type satisfying TradingStrategy, which the engine then calls without virtual dispatch.
  */
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-class IStrategy {
+class StrategyBase {
    public:
-    IStrategy(Portfolio<numberOfSymbols, Distribution> portfolio) : portfolio_(portfolio) {}
-    virtual ~IStrategy() = default;
+    StrategyBase(Portfolio<numberOfSymbols, Distribution> portfolio) : portfolio_(portfolio) {}
 
-    virtual void onStart() {}
-    virtual void onMarketData(const MarketState<depth, numberOfSymbols>& marketState) {}
-    virtual void onEnd() {}
+    /**
+     * @brief Called by the engine when a fill notification arrives.
+     */
+    void onFill(const Fill& fill) { portfolio_.updatePortfolio(fill); }
 
-    void setEngine(Engine<depth, numberOfSymbols, Distribution>* engine) { engine_ = engine; }
+    /**
+     * @brief Write the strategy's state into an engine snapshot.
+     * @details Writes the portfolio and pending orders kept here. Strategies with state of their
+     * own provide their own saveState and loadState, calling these first.
+     */
+    void saveState(SnapshotWriter& out) const {
+        portfolio_.save(out);
+        pendingOrders.save(out);
+    }
 
-    void onFill(const Fill& fill) { portfolio_.updatePortfolio(fill); }
+    /**
+     * @brief Read back what saveState wrote, when a snapshot is restored or forked.
+     * @return False if the snapshot is truncated.
+     */
+    bool loadState(SnapshotReader& in) { return portfolio_.load(in) && pendingOrders.load(in); }
+
+    void setEngine(Engine<depth, numberOfSymbols, Distribution>* engine) { engine_ = engine; }
 
     OrderId placeOrder(std::uint16_t symbol,
         OrderInstruction instruction,
@@ -54,6 +61,9 @@ class IStrategy {
         OrderId orderId =
             engine_->placeOrder(symbol, instruction, orderType, quantity, timeInForce, price);
 
+        // A rejected order never reaches the market, so it is not tracked and locks no funds
+        if (orderId == OrderId{0}) return orderId;
+
         NewOrder newOrder{orderId, symbol, timeInForce, instruction, orderType, price, quantity};
 
         Ticks orderValue = (price > Ticks{0}) ? (price * quantity) : Ticks{0};
@@ -61,7 +71,7 @@ class IStrategy {
         PendingOrder pendingOrder;
         pendingOrder.order = newOrder;
         pendingOrder.sendTime = engine_->marketData->currentTimeStamp();
-        pendingOrders.push_back(std::move(pendingOrder));
+        pendingOrders.insert(pendingOrder);
 
         // Immediately update strategy portfolio when order is placed
         // This simulates real-world behavior where placing an order locks up funds
@@ -88,13 +98,11 @@ class IStrategy {
 
         // If cancellation was successful, return funds to settled funds
         if (success) {
-            auto it = std::find_if(pendingOrders.begin(), pendingOrders.end(),
-                [orderId](const PendingOrder& po) { return po.order.id == orderId; });
-
-            if (it != pendingOrders.end()) {
-                Ticks orderValue = it->order.price * it->order.quantity;
+            if (const PendingOrder* pendingOrder = pendingOrders.find(orderId)) {
+                const NewOrder& order = pendingOrder->order;
+                Ticks orderValue = order.price * order.quantity;
                 // Return funds based on original order
-                if (it->order.instruction == OrderInstruction::Buy) {
+                if (order.instruction == OrderInstruction::Buy) {
                     // Calculate how much was on margin vs settled funds
 
                     Ticks settledUsed = std::min(orderValue, portfolio_.settledFunds + orderValue);
@@ -105,13 +113,13 @@ class IStrategy {
 
                     // Reduce loan amount for margin portion
                     portfolio_.loan -= marginAmount;
-                } else if (it->order.instruction == OrderInstruction::Sell) {
+                } else if (order.instruction == OrderInstruction::Sell) {
                     // Remove the immediate credit
                     portfolio_.settledFunds -= orderValue;
                 }
 
                 // Remove from pending orders
-                pendingOrders.erase(it);
+                pendingOrders.erase(orderId);
             }
         }
 
@@ -137,11 +145,105 @@ class IStrategy {
     }
 
    protected:
+    ~StrategyBase() = default;
+
     Engine<depth, numberOfSymbols, Distribution>* engine_{nullptr};
     Portfolio<numberOfSymbols, Distribution> portfolio_;
 
     // Track orders for fund management
-    std::vector<PendingOrder> pendingOrders;
+    PendingOrderStore pendingOrders;
 };
 
+/**
+ * @brief Interface for trading strategies
+ * @details
+ * Abstract base class that defines the contract for trading strategies.
+ * Strategies implement specific trading logic and receive callbacks from
+ * the simulation engine at key events during the simulation.
+ *
+ * The strategy interface provides a clean separation between trading logic
+ * and simulation infrastructure. Strategies can focus on their specific
+ * algorithms while the engine handles market data, order execution, and
+ * portfolio management.
+ *
+ * Key strategy callbacks:
+ * - onSymbolUpdate: Called with the id of the symbol whose quote changed
+ * - onMarketData: Called when new market data arrives, by the default onSymbolUpdate
+ * - onFill: Called when orders are executed
+ * - onEnd: Called at the end of simulation
+ *
+ * Strategies used through an IStrategy reference or pointer are dispatched virtually on every
+ * quote. Passing the concrete type to the engine binds the callbacks at compile time instead,
+ * which inlines them when the type is final.
+ */
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+class IStrategy : public StrategyBase<depth, numberOfSymbols, Distribution> {
+   public:
+    IStrategy(Portfolio<numberOfSymbols, Distribution> portfolio)
+        : StrategyBase<depth, numberOfSymbols, Distribution>(portfolio) {}
+    virtual ~IStrategy() = default;
+
+    virtual void onStart() {}
+    virtual void onMarketData(const MarketState<depth, numberOfSymbols>& marketState) {}
+
+    /**
+     * @brief Called by the engine on every quote with the symbol that quote updated.
+     * @details Override to react only to the symbols a strategy trades; the default forwards to
+     * onMarketData so strategies written against it are unchanged.
+     * @param marketState Market state after the update.
+     * @param symbolId The symbol whose quote changed.
+     */
+    virtual void onSymbolUpdate(const MarketState<depth, numberOfSymbols>& marketState,
+        std::uint16_t symbolId) {
+        onMarketData(marketState);
+    }
+
+    virtual void onEnd() {}
+
+    /**
+     * @brief Write the strategy's state into an engine snapshot.
+     * @details The base writes the portfolio and pending orders. Strategies with state of their
+     * own override this and loadState, calling the base versions first.
+     */
+    virtual void saveState(SnapshotWriter& out) const {
+        StrategyBase<depth, numberOfSymbols, Distribution>::saveState(out);
+    }
+
+    /**
+     * @brief Read back what saveState wrote, when a snapshot is restored or forked.
+     * @return False if the snapshot is truncated.
+     */
+    virtual bool loadState(SnapshotReader& in) {
+        return StrategyBase<depth, numberOfSymbols, Distribution>::loadState(in);
+    }
+};
+
+/**
+ * @brief A strategy the engine can call without going through IStrategy
+ * @details
+ * A StrategyBase with the engine callbacks as members of its own. Engine entry points are
+ * templated on the strategy type, so given a type satisfying this the simulation loop calls
+ * its callbacks directly and the compiler can inline them into the loop. Every IStrategy
+ * satisfies it too, dispatching virtually.
+ */
+template <typename Strategy,
+    std::size_t depth,
+    std::uint16_t numberOfSymbols,
+    typename Distribution>
+concept TradingStrategy =
+    std::derived_from<Strategy, StrategyBase<depth, numberOfSymbols, Distribution>> &&
+    requires(Strategy& strategy,
+        const Strategy& constStrategy,
+        const MarketState<depth, numberOfSymbols>& marketState,
+        std::uint16_t symbolId,
+        const Fill& fill,
+        SnapshotWriter& out,
+        SnapshotReader& in) {
+        strategy.onSymbolUpdate(marketState, symbolId);
+        strategy.onFill(fill);
+        strategy.onEnd();
+        constStrategy.saveState(out);
+        { strategy.loadState(in) } -> std::same_as<bool>;
+    };
+
 }  // namespace sim
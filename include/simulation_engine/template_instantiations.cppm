@@ -16,13 +16,21 @@ export namespace sim {
 
 // RunParams struct instantiations (header-only)
 template struct RunParams<ConstantDistribution>;
+template struct RunParams<BetaDistribution>;
+template struct RunParams<AnyDistribution>;
 
 // RunningStatistics class instantiations (header-only)
 template class RunningStatistics<ConstantDistribution>;
+template class RunningStatistics<BetaDistribution>;
+template class RunningStatistics<AnyDistribution>;
 
 // IStrategy class instantiations (header-only)
 template class IStrategy<10, 1, ConstantDistribution>;
 template class IStrategy<10, 4, ConstantDistribution>;
+template class IStrategy<10, 1, BetaDistribution>;
+template class IStrategy<10, 4, BetaDistribution>;
+template class IStrategy<10, 1, AnyDistribution>;
+template class IStrategy<10, 4, AnyDistribution>;
 
 // IMarketData class instantiations (header-only)
 template class IMarketData<10, 4>;
@@ -12,6 +12,13 @@ enum class VerbosityLevel : std::uint8_t {
     DETAILED = 2
 };
 
+// Memory layout of the quotes buffered by a market data source
+enum class QuoteLayout : std::uint8_t {
+    Rows = 0,     // One Quote per row (array of structs)
+    Columns = 1,  // One array per field (struct of arrays)
+    Compact = 2,  // Narrow offsets and sizes, half the memory of Rows
+};
+
 enum class Metric : std::uint8_t { 
     Dollars = 0, 
     Percent = 1, 
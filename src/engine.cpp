@@ -15,17 +15,56 @@ Engine<depth, numberOfSymbols, Distribution>::Engine(
     RunParams<Distribution> params)
     : marketData(std::move(marketData)),
       params_(params),
-      statistics(params),
+      statistics(params_),
       portfolio(params),
       buyFillRateDistribution{params.buyFillRateDistribution},
       sellFillRateDistribution{params.sellFillRateDistribution},
-      randomNumberGenerator{std::random_device{}()},
       verbosityLevel{params.verbosityLevel},
       statisticsUpdateRateSeconds{params.statisticsUpdateRateSeconds},
       sendLatencyNs{params.sendLatencyNanoseconds},
       receiveLatencyNs{params.receiveLatencyNanoseconds},
-      totalLatencyNs{params.receiveLatencyNanoseconds + params.sendLatencyNanoseconds},
-      leverageFactor{params.leverageFactor} {}
+      leverageFactor{params.leverageFactor} {
+    // Keep the seed drawn for an unseeded run, so the report can say how to replay it
+    if (!params_.fillRateSeed) {
+        std::random_device device;
+        params_.fillRateSeed = (std::uint64_t{device()} << 32) | device();
+    }
+    for (std::uint16_t symbol = 0; symbol < numberOfSymbols; ++symbol) {
+        fillRateKeys[symbol] = deriveStreamKey(*params_.fillRateSeed, params_.trialIndex, symbol);
+    }
+
+    // Latencies are consumed in a fixed order within a run, so each direction draws its whole
+    // sequence from one stream, a block at a time
+    if (params_.sendLatencyDistribution) {
+        sendLatencySamples.emplace(*params_.sendLatencyDistribution,
+            RandomStream(deriveStreamKey(
+                             *params_.fillRateSeed, params_.trialIndex, kSendLatencyStreamKey),
+                0));
+    }
+    if (params_.receiveLatencyDistribution) {
+        receiveLatencySamples.emplace(*params_.receiveLatencyDistribution,
+            RandomStream(deriveStreamKey(
+                             *params_.fillRateSeed, params_.trialIndex, kReceiveLatencyStreamKey),
+                0));
+    }
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+std::uint64_t Engine<depth, numberOfSymbols, Distribution>::nextSendLatency() {
+    if (!sendLatencySamples) return sendLatencyNs;
+    return static_cast<std::uint64_t>(std::max(0.0, std::round(sendLatencySamples->next())));
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+std::uint64_t Engine<depth, numberOfSymbols, Distribution>::nextReceiveLatency() {
+    if (!receiveLatencySamples) return receiveLatencyNs;
+    return static_cast<std::uint64_t>(std::max(0.0, std::round(receiveLatencySamples->next())));
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+std::uint64_t Engine<depth, numberOfSymbols, Distribution>::nextRoundTripLatency() {
+    return nextSendLatency() + nextReceiveLatency();
+}
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
 bool Engine<depth, numberOfSymbols, Distribution>::canTrade(TimeStamp currentTimeStamp) const {
@@ -76,19 +115,119 @@ template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distributio
 Result<numberOfSymbols, Distribution> Engine<depth, numberOfSymbols, Distribution>::run(
     IStrategy<depth, numberOfSymbols, Distribution>& strategy,
     std::ostream& out) {
-    this->strategy = &strategy;
-    strategy.setEngine(this);
-    Result<numberOfSymbols, Distribution> result = simulate(strategy);
-    statistics.outputSummary(out, verbosityLevel);
-    return result;
+    // The loop compiled for virtual dispatch, for strategies only known as an IStrategy
+    return run<FullRealism, IStrategy<depth, numberOfSymbols, Distribution>>(strategy, out);
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+void Engine<depth, numberOfSymbols, Distribution>::saveEngineState(SnapshotWriter& out) const {
+    SnapshotHeader header;
+    header.numberOfSymbols = numberOfSymbols;
+    header.depth = depth;
+    header.fillRateSeed = *params_.fillRateSeed;
+    header.trialIndex = params_.trialIndex;
+
+    out.write(header);
+    marketData->saveCursor(out);
+    portfolio.save(out);
+    pendingOrders.save(out);
+    inFlightOrders.save(out);
+    scheduledActions.save(out);
+    scheduledNotifications.save(out);
+    statistics.save(out);
+
+    // Fill rates are drawn from streams named by order and attempt, so the seed above and the
+    // orders' fill attempts are all of their state. Latencies are drawn in sequence
+    saveLatencySamples(out, sendLatencySamples);
+    saveLatencySamples(out, receiveLatencySamples);
+
+    out.write(symbolsToMatch);
+    out.write(fills);
+    out.write(static_cast<std::uint64_t>(quotesProcessed));
+    out.write(nextOrderId);
+    out.write(lastSettlementDate);
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+bool Engine<depth, numberOfSymbols, Distribution>::restoreEngineState(SnapshotReader& in) {
+    // Reject snapshots of other engines before changing anything
+    SnapshotHeader header;
+    if (!in.read(header) || header.magic != kSnapshotMagic ||
+        header.version != kSnapshotVersion || header.numberOfSymbols != numberOfSymbols ||
+        header.depth != depth) {
+        return false;
+    }
+
+    // Keep drawing from the fill-rate streams of the original run
+    params_.fillRateSeed = header.fillRateSeed;
+    params_.trialIndex = header.trialIndex;
+    for (std::uint16_t symbol = 0; symbol < numberOfSymbols; ++symbol) {
+        fillRateKeys[symbol] = deriveStreamKey(*params_.fillRateSeed, params_.trialIndex, symbol);
+    }
+
+    if (!marketData->restoreCursor(in) || !portfolio.load(in) || !pendingOrders.load(in) ||
+        !inFlightOrders.load(in) || !scheduledActions.load(in) ||
+        !scheduledNotifications.load(in) || !statistics.load(in) ||
+        !loadLatencySamples(in, sendLatencySamples) ||
+        !loadLatencySamples(in, receiveLatencySamples)) {
+        return false;
+    }
+
+    std::uint64_t processed = 0;
+    if (!in.read(symbolsToMatch) || !in.read(fills) || !in.read(processed) ||
+        !in.read(nextOrderId) || !in.read(lastSettlementDate)) {
+        return false;
+    }
+    quotesProcessed = static_cast<std::size_t>(processed);
+
+    // The price index is derived from the working orders
+    restingOrders.clear();
+    for (const PendingOrder& pendingOrder : pendingOrders) {
+        restingOrders.add(pendingOrder.order);
+    }
+
+    return true;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+std::unique_ptr<Engine<depth, numberOfSymbols, Distribution>>
+Engine<depth, numberOfSymbols, Distribution>::fork(
+    std::unique_ptr<IMarketData<depth, numberOfSymbols>> branchMarketData,
+    IStrategy<depth, numberOfSymbols, Distribution>& branchStrategy) const {
+    if (strategy == nullptr) return nullptr;
+
+    auto branch = std::make_unique<Engine>(std::move(branchMarketData), params_);
+    if (!branch->restore(snapshot(*strategy), branchStrategy)) return nullptr;
+    return branch;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+void Engine<depth, numberOfSymbols, Distribution>::saveLatencySamples(SnapshotWriter& out,
+    const std::optional<SampleBuffer<AnyDistribution>>& samples) {
+    out.write(samples.has_value());
+    if (samples) samples->save(out);
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+bool Engine<depth, numberOfSymbols, Distribution>::loadLatencySamples(SnapshotReader& in,
+    std::optional<SampleBuffer<AnyDistribution>>& samples) {
+    // The distributions come from RunParams, so both runs must sample the same directions
+    bool sampled = false;
+    if (!in.read(sampled) || sampled != samples.has_value()) return false;
+    return !sampled || samples->load(in);
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
+Ticks Engine<depth, numberOfSymbols, Distribution>::currentPortfolioValue() const {
+    return portfolio.netLiquidationValue();
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
 bool Engine<depth, numberOfSymbols, Distribution>::sufficientEquityForOrder(const NewOrder& order) {
     assert(order.orderType == OrderType::Limit || order.orderType == OrderType::Market);
 
-    return portfolio.sufficientEquityForOrder(marketData->bestBids(), marketData->bestAsks(), order,
-        this->estimateTotalOrderPrice(order), leverageFactor);
+    return portfolio.sufficientEquityForOrder(order, this->estimateTotalOrderPrice(order),
+        leverageFactor);
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
@@ -109,35 +248,11 @@ Ticks Engine<depth, numberOfSymbols, Distribution>::estimateTotalOrderPrice(NewO
             return order.quantity * bestBid;
         }
     } else if (order.orderType == OrderType::Market) {
-        if (order.instruction == OrderInstruction::Buy) {
-            Ticks totalOrderPrice{0};
-            Quantity numberOfSharesRemaining = order.quantity;
-
-            for (std::size_t level = 0; level < depth; ++level) {
-                Ticks askSize = marketData->getAskSize(order.symbol, level);
-
-                if (askSize <= numberOfSharesRemaining.value()) {
-                    numberOfSharesRemaining -= askSize.value();
-                    totalOrderPrice += marketData->getAsk(order.symbol, level) * askSize;
-                } else {
-                    break;
-                }
-            }
-        } else if (order.instruction == OrderInstruction::Sell) {
-            Ticks totalOrderPrice{0};
-            Quantity numberOfSharesRemaining = order.quantity;
-
-            for (std::size_t level = 0; level < depth; ++level) {
-                Ticks bidSize = marketData->getBidSize(order.symbol, level);
-
-                if (bidSize <= numberOfSharesRemaining.value()) {
-                    numberOfSharesRemaining -= bidSize.value();
-                    totalOrderPrice += marketData->getBid(order.symbol, level) * bidSize;
-                } else {
-                    break;
-                }
-            }
-        }
+        // Notional of the levels the order would consume completely
+        const DepthLadder<depth> ladder =
+            makeDepthLadder(marketData->getQuote(order.symbol), order.instruction);
+        totalOrderPrice =
+            fullLevelNotional(ladder, static_cast<std::int64_t>(order.quantity.value()));
     }
     return totalOrderPrice;
 }
@@ -159,8 +274,8 @@ OrderId Engine<depth, numberOfSymbols, Distribution>::placeOrder(std::uint16_t s
     order.price = price;
 
     Ticks estimatedPrice = estimateTotalOrderPrice(order);
-    bool sufficientEquityForOrder = portfolio.sufficientEquityForOrder(
-        marketData->bestBids(), marketData->bestAsks(), order, estimatedPrice, leverageFactor);
+    bool sufficientEquityForOrder =
+        portfolio.sufficientEquityForOrder(order, estimatedPrice, leverageFactor);
 
     if (!sufficientEquityForOrder) {
         std::cout << "Conditions not met to place order!";
@@ -168,14 +283,16 @@ OrderId Engine<depth, numberOfSymbols, Distribution>::placeOrder(std::uint16_t s
     }
 
     TimeStamp sendTime = marketData->currentTimeStamp();
-    TimeStamp earliestExecution = TimeStamp(sendTime.value() + totalLatencyNs);
+    TimeStamp earliestExecution = TimeStamp(sendTime.value() + nextRoundTripLatency());
 
     PendingOrder pendingOrder;
     pendingOrder.order = order;
     pendingOrder.sendTime = sendTime;
     pendingOrder.earliestExecution = earliestExecution;
 
-    pendingOrders.push_back(pendingOrder);
+    // The order only starts working once it reaches the exchange
+    inFlightOrders.insert(pendingOrder);
+    scheduledActions.push(earliestExecution, OrderArrival{order.id});
 
     statistics.recordOrder(order, sendTime);
 
@@ -184,21 +301,18 @@ OrderId Engine<depth, numberOfSymbols, Distribution>::placeOrder(std::uint16_t s
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
 bool Engine<depth, numberOfSymbols, Distribution>::cancel(OrderId orderId) {
-    // Check if order exists in pending orders
-    auto it = std::find_if(pendingOrders.begin(), pendingOrders.end(),
-        [orderId](const PendingOrder& po) { return po.order.id == orderId; });
-
-    if (it != pendingOrders.end()) {
+    // Check if order is working or still in flight
+    if (pendingOrders.contains(orderId) || inFlightOrders.contains(orderId)) {
         // Add cancel order with latency
         TimeStamp sendTime = marketData->currentTimeStamp();
-        TimeStamp earliestExecution = TimeStamp(sendTime.value() + totalLatencyNs);
+        TimeStamp earliestExecution = TimeStamp(sendTime.value() + nextRoundTripLatency());
 
         CancelOrder cancelOrder;
         cancelOrder.orderId = orderId;
         cancelOrder.sendTime = sendTime;
         cancelOrder.earliestExecution = earliestExecution;
 
-        pendingCancels.push_back(cancelOrder);
+        scheduledActions.push(earliestExecution, cancelOrder);
         return true;
     }
     return false;
@@ -208,14 +322,11 @@ template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distributio
 bool Engine<depth, numberOfSymbols, Distribution>::replace(OrderId orderId,
     Quantity newQuantity,
     Ticks newPrice) {
-    // Check if order exists in pending orders
-    auto it = std::find_if(pendingOrders.begin(), pendingOrders.end(),
-        [orderId](const PendingOrder& po) { return po.order.id == orderId; });
-
-    if (it != pendingOrders.end()) {
+    // Check if order is working or still in flight
+    if (pendingOrders.contains(orderId) || inFlightOrders.contains(orderId)) {
         // Add replace order with latency
         TimeStamp sendTime = marketData->currentTimeStamp();
-        TimeStamp earliestExecution = TimeStamp(sendTime.value() + totalLatencyNs);
+        TimeStamp earliestExecution = TimeStamp(sendTime.value() + nextRoundTripLatency());
 
         ReplaceOrder replaceOrder;
         replaceOrder.orderId = orderId;
@@ -224,195 +335,47 @@ bool Engine<depth, numberOfSymbols, Distribution>::replace(OrderId orderId,
         replaceOrder.sendTime = sendTime;
         replaceOrder.earliestExecution = earliestExecution;
 
-        pendingReplaces.push_back(replaceOrder);
+        scheduledActions.push(earliestExecution, replaceOrder);
         return true;
     }
     return false;
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-Result<numberOfSymbols, Distribution> Engine<depth, numberOfSymbols, Distribution>::simulate(
-    IStrategy<depth, numberOfSymbols, Distribution>& strategy) {
-    this->strategy = &strategy;
-
-    // Process market data
-    while (marketData->nextMarketState()) {
-        ++quotesProcessed;
-
-        // Send strategy market data
-        strategy.onMarketData(marketData->currentMarketState());
-
-        // Check margin requirements and execute margin calls if necessary
-        checkMarginRequirement();
-
-        // Try to fill orders after 'sendLatency' + 'receiveLatency' has
-        // passed since order was sent from strategy.
-        processPendingOrders();
-
-        // Send fill notifications to strategy after 'receiveLatency' time has passed since fill.
-        processPendingNotifications(strategy);
-
-        // Process settlements each morning after 9am
-        processSettlements();
-    }
-
-    strategy.onEnd();
-
-    // Update final statistics including interest owed
-    statistics.updateInterestOwed(portfolio.interestOwed);
-
-    return Result{std::move(fills), portfolio, quotesProcessed};
-}
+double Engine<depth, numberOfSymbols, Distribution>::determineFillRate(const NewOrder& order,
+    std::uint32_t fillAttempt) {
+    // Each attempt of each order draws from its own stream, so the rate does not depend on what
+    // other orders drew before it
+    RandomStream stream(fillRateKeys[order.symbol], order.id.value(), fillAttempt);
 
-template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-double Engine<depth, numberOfSymbols, Distribution>::determineFillRate(std::mt19937& rng,
-    OrderInstruction orderInstruction) {
     // Get a value between 1 and 100 from the distribution and convert it to an integer
-    switch (orderInstruction) {
+    switch (order.instruction) {
         case OrderInstruction::Buy: {
-            return std::clamp(buyFillRateDistribution(randomNumberGenerator), 0.0, 100.0);
+            return std::clamp(buyFillRateDistribution(stream), 0.0, 100.0);
         }
         case OrderInstruction::Sell: {
-            return std::clamp(sellFillRateDistribution(randomNumberGenerator), 0.0, 100.0);
+            return std::clamp(sellFillRateDistribution(stream), 0.0, 100.0);
         }
     }
     return 0.0;  // Should never reach here
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-Quantity Engine<depth, numberOfSymbols, Distribution>::numberOfSharesToFillForLimitOrder(
-    const Quote<depth>& quote,
-    OrderInstruction orderInstruction,
-    Ticks price,
-    Quantity desiredNumberOfShares) {
-    int numberOfSharesAvailable = 0;
-
-    switch (orderInstruction) {
-        case OrderInstruction::Buy: {
-            for (std::size_t level = 0;
-                level < depth && numberOfSharesAvailable < desiredNumberOfShares; ++level) {
-                Ticks askPrice = quote.getAsk(level);
-                if (askPrice <= price) {
-                    numberOfSharesAvailable += static_cast<int>(quote.getAskSize(level).value());
-                } else {
-                    break;
-                }
-            }
-            break;
-        }
-        case OrderInstruction::Sell: {
-            for (std::size_t level = 0;
-                level < depth && numberOfSharesAvailable < desiredNumberOfShares; ++level) {
-                if (quote.getBid(level) >= price) {
-                    numberOfSharesAvailable += static_cast<int>(quote.getBidSize(level).value());
-                } else {
-                    break;
-                }
-            }
-            break;
-        }
-    }
-
-    double fillRate = determineFillRate(randomNumberGenerator, orderInstruction);
-
-    int minShares =
-        std::min(numberOfSharesAvailable, static_cast<int>(desiredNumberOfShares.value()));
-    int sharesToFill = static_cast<int>(std::round(minShares * fillRate / 100.0));
-    return Quantity{static_cast<std::uint32_t>(std::max(0, sharesToFill))};
-}
-
-template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-Quantity Engine<depth, numberOfSymbols, Distribution>::numberOfSharesToFillForMarketOrder(
-    const Quote<depth>& quote,
-    OrderInstruction orderInstruction,
-    Quantity desiredNumberOfShares) {
-    int numberOfSharesAvailable = 0;
-
-    switch (orderInstruction) {
-        case OrderInstruction::Buy: {
-            for (std::size_t level = 0;
-                level < depth && numberOfSharesAvailable < desiredNumberOfShares; ++level) {
-                numberOfSharesAvailable += static_cast<int>(quote.getAskSize(level).value());
-            }
-            break;
-        }
-        case OrderInstruction::Sell: {
-            for (std::size_t level = 0;
-                level < depth && numberOfSharesAvailable < desiredNumberOfShares; ++level) {
-                numberOfSharesAvailable += static_cast<int>(quote.getBidSize(level).value());
-            }
-            break;
-        }
-    }
-
-    double fillRate = determineFillRate(randomNumberGenerator, orderInstruction);
-
-    int minShares =
-        std::min(numberOfSharesAvailable, static_cast<int>(desiredNumberOfShares.value()));
+Quantity Engine<depth, numberOfSymbols, Distribution>::numberOfSharesToFill(
+    std::int64_t numberOfSharesAvailable,
+    const NewOrder& order,
+    double fillRate) {
+    int minShares = static_cast<int>(std::min<std::int64_t>(numberOfSharesAvailable,
+        static_cast<std::int64_t>(order.quantity.value())));
     int sharesToFill = static_cast<int>(std::round(minShares * fillRate / 100.0));
     return Quantity{static_cast<std::uint32_t>(std::max(0, sharesToFill))};
 }
 
-template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-Ticks Engine<depth, numberOfSymbols, Distribution>::averageExecutionPrice(const Quote<depth>& quote,
-    Quantity numberOfShares,
-    OrderInstruction orderInstruction) {
-    Ticks totalPrice{0};
-    Quantity totalShares{0};
-    switch (orderInstruction) {
-        case OrderInstruction::Buy: {
-            for (std::size_t level = 0; level < depth && totalShares < numberOfShares; ++level) {
-                Ticks askPrice = quote.getAsk(level);
-                Ticks askSize = quote.getAskSize(level);
-                Quantity sharesAtLevel = Quantity{static_cast<std::uint32_t>(askSize.value())};
-                Quantity sharesToUse = (totalShares + sharesAtLevel <= numberOfShares)
-                    ? sharesAtLevel
-                    : Quantity{numberOfShares.value() - totalShares.value()};
-                totalPrice += askPrice * sharesToUse;
-                totalShares += sharesToUse;
-            }
-            break;
-        }
-        case OrderInstruction::Sell: {
-            for (std::size_t level = 0; level < depth && totalShares < numberOfShares; ++level) {
-                Ticks bidPrice = quote.getBid(level);
-                Ticks bidSize = quote.getBidSize(level);
-                Quantity sharesAtLevel = Quantity{static_cast<std::uint32_t>(bidSize.value())};
-                Quantity sharesToUse = (totalShares + sharesAtLevel <= numberOfShares)
-                    ? sharesAtLevel
-                    : Quantity{numberOfShares.value() - totalShares.value()};
-                totalPrice += bidPrice * sharesToUse;
-                totalShares += sharesToUse;
-            }
-            break;
-        }
-    }
-
-    if (totalShares.value() > 0) {
-        return totalPrice / totalShares;
-    }
-    return Ticks{0};
-}
-
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
 ExecutionResult Engine<depth, numberOfSymbols, Distribution>::tryExecute(const NewOrder& newOrder,
-    TimeStamp sendTs) {
-    Quantity numberOfSharesToFill;
-    const Quote<depth> quote = marketData->currentMarketState().getQuote(newOrder.symbol);
-
-    switch (newOrder.orderType) {
-        case OrderType::Market: {
-            numberOfSharesToFill =
-                numberOfSharesToFillForMarketOrder(quote, newOrder.instruction, newOrder.quantity);
-            break;
-        }
-        case OrderType::Limit: {
-            numberOfSharesToFill = numberOfSharesToFillForLimitOrder(
-                quote, newOrder.instruction, newOrder.price, newOrder.quantity);
-            break;
-        }
-    }
-
+    TimeStamp sendTs,
+    Quantity numberOfSharesToFill,
+    Ticks avgExecPrice) {
     // Skip creating fills when no shares are available to fill
     if (numberOfSharesToFill.value() == 0) {
         ExecutionResult result;
@@ -423,9 +386,6 @@ ExecutionResult Engine<depth, numberOfSymbols, Distribution>::tryExecute(const N
         return result;
     }
 
-    Ticks avgExecPrice = this->averageExecutionPrice(
-        marketData->getQuote(newOrder.symbol), numberOfSharesToFill, newOrder.instruction);
-
     ExecutionResult result;
     result.fills.clear();
     result.remainingOrder = newOrder;
@@ -450,15 +410,14 @@ ExecutionResult Engine<depth, numberOfSymbols, Distribution>::tryExecute(const N
 
     result.fills.push_back(fill);
 
-    Ticks portfolioLiquidationValue =
-        portfolio.netLiquidationValue(marketData->bestBids(), marketData->bestAsks());
+    Ticks portfolioLiquidationValue = portfolio.netLiquidationValue();
 
     portfolio.updatePortfolio(fill);
     statistics.recordFill(fill);
     statistics.updateStatistics(portfolioLiquidationValue);
     statistics.updateInterestOwed(portfolio.interestOwed);
 
-    TimeStamp notificationTime = TimeStamp{fill.timestamp.value() + receiveLatencyNs};
+    TimeStamp notificationTime = TimeStamp{fill.timestamp.value() + nextReceiveLatency()};
     notifyFill(fill, notificationTime);
 
     return result;
@@ -471,125 +430,77 @@ void Engine<depth, numberOfSymbols, Distribution>::notifyFill(const Fill& fill,
     fills.push_back(fill);
 
     // Queue notification for later delivery
-    pendingNotifications.push_back({fill, earliestNotificationTime, false});
+    scheduledNotifications.push(earliestNotificationTime,
+        PendingNotification{fill, earliestNotificationTime, false});
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-void Engine<depth, numberOfSymbols, Distribution>::processPendingNotifications(
-    IStrategy<depth, numberOfSymbols, Distribution>& strategy) {
-    auto it = pendingNotifications.begin();
-    while (it != pendingNotifications.end()) {
-        if (!it->delivered && marketData->currentTimeStamp() >= it->earliestNotifyTime) {
-            // Time to deliver the notification
-            strategy.onFill(it->fill);
-            it->delivered = true;
-            ++it;
-        } else {
-            ++it;
-        }
+void Engine<depth, numberOfSymbols, Distribution>::processDueActions() {
+    const TimeStamp currentTime = marketData->currentTimeStamp();
+    while (scheduledActions.due(currentTime)) {
+        applyScheduledAction(scheduledActions.pop().action);
     }
-
-    // Remove delivered notifications to keep the queue clean
-    pendingNotifications.erase(
-        std::remove_if(pendingNotifications.begin(), pendingNotifications.end(),
-            [](const PendingNotification& notification) { return notification.delivered; }),
-        pendingNotifications.end());
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-void Engine<depth, numberOfSymbols, Distribution>::processPendingCancelOrders() {
-    // Process pending cancel orders first
-    auto cancelIt = pendingCancels.begin();
-    while (cancelIt != pendingCancels.end()) {
-        if (marketData->currentTimeStamp() >= cancelIt->earliestExecution) {
-            // Time to execute the cancel - remove the corresponding order
-            auto orderIt = std::find_if(pendingOrders.begin(), pendingOrders.end(),
-                [cancelIt](const PendingOrder& po) { return po.order.id == cancelIt->orderId; });
-
-            if (orderIt != pendingOrders.end()) {
-                pendingOrders.erase(orderIt);
-            }
-
-            // Remove the cancel order
-            cancelIt = pendingCancels.erase(cancelIt);
-        } else {
-            ++cancelIt;
-        }
+void Engine<depth, numberOfSymbols, Distribution>::applyScheduledAction(
+    const ScheduledAction& action) {
+    if (const auto* cancelOrder = std::get_if<CancelOrder>(&action)) {
+        applyCancel(*cancelOrder);
+    } else if (const auto* replaceOrder = std::get_if<ReplaceOrder>(&action)) {
+        applyReplace(*replaceOrder);
+    } else if (const auto* arrival = std::get_if<OrderArrival>(&action)) {
+        activateOrder(arrival->orderId);
     }
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-void Engine<depth, numberOfSymbols, Distribution>::processPendingReplaceOrders() {
-    // Process pending replace orders
-    auto replaceIt = pendingReplaces.begin();
-    while (replaceIt != pendingReplaces.end()) {
-        if (marketData->currentTimeStamp() >= replaceIt->earliestExecution) {
-            // Time to execute the replace - modify the corresponding order
-            auto orderIt = std::find_if(pendingOrders.begin(), pendingOrders.end(),
-                [replaceIt](const PendingOrder& po) { return po.order.id == replaceIt->orderId; });
-
-            if (orderIt != pendingOrders.end()) {
-                orderIt->order.quantity = replaceIt->newQuantity;
-                orderIt->order.price = replaceIt->newPrice;
-            }
-
-            // Remove the replace order
-            replaceIt = pendingReplaces.erase(replaceIt);
-        } else {
-            ++replaceIt;
-        }
+void Engine<depth, numberOfSymbols, Distribution>::applyCancel(const CancelOrder& cancelOrder) {
+    if (const PendingOrder* pendingOrder = pendingOrders.find(cancelOrder.orderId)) {
+        restingOrders.remove(pendingOrder->order);
+        pendingOrders.erase(cancelOrder.orderId);
+    } else {
+        // The order may still be in flight if it was sent on the same quote as the cancel
+        inFlightOrders.erase(cancelOrder.orderId);
     }
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-void Engine<depth, numberOfSymbols, Distribution>::processPendingBuySellOrders() {
-    // Process pending orders
-    auto pendingIt = pendingOrders.begin();
-    while (pendingIt != pendingOrders.end()) {
-        if (marketData->currentTimeStamp() >= pendingIt->earliestExecution) {
-            // Only try to execute if we are within trading hours
-            if (!canTrade(marketData->currentTimeStamp())) {
-                ++pendingIt;
-                continue;  // Order stays in pendingOrders for the next quote
-            }
-
-            ExecutionResult result = tryExecute(pendingIt->order, pendingIt->sendTime);
-            if (result.isComplete) {
-                // Order is complete, remove from pending
-                pendingIt = pendingOrders.erase(pendingIt);
-            } else {
-                // Order partially filled, update remaining quantity
-                if (result.remainingOrder.quantity.value() != 0) {
-                    pendingIt->order = result.remainingOrder;
-                    ++pendingIt;
-                }
-            }
-        } else {
-            ++pendingIt;
+void Engine<depth, numberOfSymbols, Distribution>::applyReplace(const ReplaceOrder& replaceOrder) {
+    if (PendingOrder* pendingOrder = pendingOrders.find(replaceOrder.orderId)) {
+        NewOrder& order = pendingOrder->order;
+        restingOrders.remove(order);
+        order.quantity = replaceOrder.newQuantity;
+        order.price = replaceOrder.newPrice;
+
+        // An order with nothing left to fill is complete
+        if (order.quantity.value() == 0) {
+            pendingOrders.erase(replaceOrder.orderId);
+            return;
         }
-    }
-}
 
-template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-void Engine<depth, numberOfSymbols, Distribution>::processPendingOrders() {
-    processPendingCancelOrders();
-    processPendingCancelOrders();
-    processPendingBuySellOrders();
+        restingOrders.add(order);
+        symbolsToMatch[order.symbol] = true;
+    } else if (PendingOrder* inFlightOrder = inFlightOrders.find(replaceOrder.orderId)) {
+        inFlightOrder->order.quantity = replaceOrder.newQuantity;
+        inFlightOrder->order.price = replaceOrder.newPrice;
+    }
+    // Otherwise the order was filled or cancelled while the replace was in flight
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
-void Engine<depth, numberOfSymbols, Distribution>::processSettlements() {
-    // Only process settlements once per day after 9am
-    TimeStamp currentTime = marketData->currentTimeStamp();
-    if (isTimeForSettlement(currentTime)) {
-        // Process unsettled funds settlements
-        portfolio.processSettlements(currentTime);
-
-        // Calculate and apply daily interest on outstanding loans
-        portfolio.calculateDailyInterest(currentTime);
-
-        lastSettlementDate = currentTime;
+void Engine<depth, numberOfSymbols, Distribution>::activateOrder(OrderId orderId) {
+    // Orders cancelled while in flight are no longer there
+    const PendingOrder* pendingOrder = inFlightOrders.find(orderId);
+    if (pendingOrder == nullptr) return;
+
+    // An order with nothing left to fill is complete
+    if (pendingOrder->order.quantity.value() != 0) {
+        pendingOrders.insert(*pendingOrder);
+        restingOrders.add(pendingOrder->order);
+        symbolsToMatch[pendingOrder->order.symbol] = true;
     }
+    inFlightOrders.erase(orderId);
 }
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
@@ -615,8 +526,8 @@ bool Engine<depth, numberOfSymbols, Distribution>::isTimeForSettlement(
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
 void Engine<depth, numberOfSymbols, Distribution>::checkMarginRequirement() {
-    bool inViolationOfMarginRequirement =
-        portfolio.violatesMarginRequirement(marketData->bestBids(), marketData->bestAsks());
+    // The portfolio is already marked at the current prices, so this is O(1)
+    bool inViolationOfMarginRequirement = portfolio.violatesMarginRequirement();
 
     if (inViolationOfMarginRequirement) {
         executeMarginCall();
@@ -625,9 +536,6 @@ void Engine<depth, numberOfSymbols, Distribution>::checkMarginRequirement() {
 
 template <std::size_t depth, std::uint16_t numberOfSymbols, typename Distribution>
 void Engine<depth, numberOfSymbols, Distribution>::executeMarginCall() {
-    auto bestBids = marketData->bestBids();
-    auto bestAsks = marketData->bestAsks();
-
     // Liquidate positions until we meet 30% maintenance requirement
     while (true) {
         // Determine what to liquidate first - start with largest positions
@@ -655,7 +563,7 @@ void Engine<depth, numberOfSymbols, Distribution>::executeMarginCall() {
             // Record the fill and queue notification
             statistics.recordFill(marginCallFill);
             TimeStamp notificationTime =
-                TimeStamp{marginCallFill.timestamp.value() + receiveLatencyNs};
+                TimeStamp{marginCallFill.timestamp.value() + nextReceiveLatency()};
             notifyFill(marginCallFill, notificationTime);
 
             liquidated = true;
@@ -682,7 +590,7 @@ void Engine<depth, numberOfSymbols, Distribution>::executeMarginCall() {
             // Record the fill and queue notification
             statistics.recordFill(marginCallFill);
             TimeStamp notificationTime =
-                TimeStamp{marginCallFill.timestamp.value() + receiveLatencyNs};
+                TimeStamp{marginCallFill.timestamp.value() + nextReceiveLatency()};
             notifyFill(marginCallFill, notificationTime);
 
             liquidated = true;
@@ -698,5 +606,9 @@ void Engine<depth, numberOfSymbols, Distribution>::executeMarginCall() {
 // Explicit template instantiations
 template class Engine<10, 1, ConstantDistribution>;
 template class Engine<10, 4, ConstantDistribution>;
+template class Engine<10, 1, BetaDistribution>;
+template class Engine<10, 4, BetaDistribution>;
+template class Engine<10, 1, AnyDistribution>;
+template class Engine<10, 4, AnyDistribution>;
 
 }  // namespace sim
@@ -0,0 +1,378 @@
+// ingest.cpp
+module;
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <arrow/io/api.h>
+#include <arrow/util/config.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+#include <unistd.h>
+
+module simulation_engine;
+
+import std;
+
+namespace sim {
+
+namespace {
+
+// Depth of the raw MBP-10 files, and so of the quote caches primed from them
+constexpr std::size_t kIngestDepth = 10;
+
+// Rows per output row group, the duckdb default the existing datasets were written with
+constexpr std::int64_t kOutputRowGroupRows = 122'880;
+
+bool isPriceColumn(const std::string& name) {
+    return name == "price" || name.starts_with("bid_px_") || name.starts_with("ask_px_");
+}
+
+/**
+ * @brief Keep the configured symbols and attach their symbol_id column.
+ */
+arrow::Result<std::shared_ptr<arrow::Table>> selectSymbols(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<std::string>& symbols) {
+    namespace compute = arrow::compute;
+
+    auto symbolColumn = table->GetColumnByName("symbol");
+    if (!symbolColumn) return arrow::Status::Invalid("Raw file has no symbol column");
+
+    // Dictionary-encoded symbols are looked up by value
+    arrow::Datum symbolValues{symbolColumn};
+    if (symbolColumn->type()->id() != arrow::Type::STRING) {
+        ARROW_ASSIGN_OR_RAISE(symbolValues, compute::Cast(symbolValues, arrow::utf8()));
+    }
+
+    arrow::StringBuilder symbolSetBuilder;
+    ARROW_RETURN_NOT_OK(symbolSetBuilder.AppendValues(symbols));
+    ARROW_ASSIGN_OR_RAISE(auto symbolSet, symbolSetBuilder.Finish());
+
+    // index_in yields each row's position in the symbol list, which is its symbol_id
+    compute::SetLookupOptions lookupOptions(symbolSet);
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum symbolIndex,
+        compute::CallFunction("index_in", {symbolValues}, &lookupOptions));
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum keep, compute::CallFunction("is_valid", {symbolIndex}));
+
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum filteredTable, compute::Filter(table, keep));
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum filteredIndex, compute::Filter(symbolIndex, keep));
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum symbolId, compute::Cast(filteredIndex, arrow::uint16()));
+
+    std::shared_ptr<arrow::Table> selected = filteredTable.table();
+    return selected->AddColumn(selected->num_columns(),
+        arrow::field("symbol_id", arrow::uint16()), symbolId.chunked_array());
+}
+
+/**
+ * @brief Replace every floating point price column with its scaled UINT64 value.
+ */
+arrow::Result<std::shared_ptr<arrow::Table>> scalePrices(std::shared_ptr<arrow::Table> table,
+    std::int64_t priceScale) {
+    namespace compute = arrow::compute;
+
+    auto scale = std::make_shared<arrow::DoubleScalar>(static_cast<double>(priceScale));
+    // Half away from zero, as duckdb rounds when casting to an integer
+    compute::RoundOptions roundOptions(0, compute::RoundMode::HALF_TOWARDS_INFINITY);
+
+    for (int column = 0; column < table->num_columns(); ++column) {
+        const std::string& name = table->field(column)->name();
+        if (!isPriceColumn(name)) continue;
+
+        const auto& type = table->field(column)->type();
+        if (!arrow::is_floating(type->id())) {
+            return arrow::Status::TypeError("Price column ", name, " is ", type->ToString(),
+                ", expected a floating point price");
+        }
+
+        arrow::Datum prices{table->column(column)};
+        ARROW_ASSIGN_OR_RAISE(prices, compute::Cast(prices, arrow::float64()));
+        ARROW_ASSIGN_OR_RAISE(prices, compute::Multiply(prices, arrow::Datum(scale)));
+        ARROW_ASSIGN_OR_RAISE(prices, compute::Round(prices, roundOptions));
+        ARROW_ASSIGN_OR_RAISE(prices, compute::Cast(prices, arrow::uint64()));
+
+        ARROW_ASSIGN_OR_RAISE(table, table->SetColumn(column,
+            arrow::field(name, arrow::uint64()), prices.chunked_array()));
+    }
+    return table;
+}
+
+/**
+ * @brief Sort rows by (ts_event, symbol_id), the order the engine replays them in.
+ */
+arrow::Result<std::shared_ptr<arrow::Table>> sortRows(const std::shared_ptr<arrow::Table>& table) {
+    namespace compute = arrow::compute;
+
+    compute::SortOptions sortOptions(
+        {compute::SortKey("ts_event"), compute::SortKey("symbol_id")});
+    ARROW_ASSIGN_OR_RAISE(auto order, compute::SortIndices(arrow::Datum(table), sortOptions));
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum sorted, compute::Take(table, order));
+    return sorted.table();
+}
+
+/**
+ * @brief Keep the configured symbols of one raw slice and scale its prices.
+ */
+arrow::Result<std::shared_ptr<arrow::Table>> selectAndScale(
+    const std::shared_ptr<arrow::Table>& table,
+    const IngestParams& params) {
+    ARROW_ASSIGN_OR_RAISE(auto selected, selectSymbols(table, params.symbols));
+    return scalePrices(std::move(selected), params.priceScale);
+}
+
+/**
+ * @brief Stream a raw day batch by batch, keeping only the rows of the configured symbols.
+ * @details Only one raw batch and the kept rows are in memory at a time, never the whole day of
+ * every symbol, so concurrent ingests stay within the footprint of the duckdb scripts.
+ * @param rowsRead Receives the number of raw rows read.
+ * @return The kept rows with scaled prices, in file order.
+ */
+arrow::Result<std::shared_ptr<arrow::Table>> readSelectedRows(const std::string& inputPath,
+    const IngestParams& params,
+    std::int64_t& rowsRead) {
+    ARROW_ASSIGN_OR_RAISE(auto input, arrow::io::ReadableFile::Open(inputPath));
+
+    // Buffered page reads rather than pre-buffered row groups, so a batch costs only its rows
+    parquet::ReaderProperties readerProperties = parquet::default_reader_properties();
+    readerProperties.enable_buffered_stream();
+
+    parquet::ArrowReaderProperties arrowProperties = parquet::default_arrow_reader_properties();
+    arrowProperties.set_use_threads(true);
+
+    parquet::arrow::FileReaderBuilder builder;
+    ARROW_RETURN_NOT_OK(builder.Open(input, readerProperties));
+    builder.memory_pool(arrow::default_memory_pool());
+    builder.properties(arrowProperties);
+
+    std::unique_ptr<parquet::arrow::FileReader> fileReader;
+    ARROW_RETURN_NOT_OK(builder.Build(&fileReader));
+
+    std::vector<int> rowGroups(fileReader->num_row_groups());
+    std::iota(rowGroups.begin(), rowGroups.end(), 0);
+    ARROW_ASSIGN_OR_RAISE(auto batchReader, fileReader->GetRecordBatchReader(rowGroups));
+
+    rowsRead = 0;
+    std::vector<std::shared_ptr<arrow::Table>> keptSlices;
+    while (true) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        ARROW_RETURN_NOT_OK(batchReader->ReadNext(&batch));
+        if (!batch) break;
+        rowsRead += batch->num_rows();
+
+        ARROW_ASSIGN_OR_RAISE(auto slice, arrow::Table::FromRecordBatches({batch}));
+        ARROW_ASSIGN_OR_RAISE(slice, selectAndScale(slice, params));
+        if (slice->num_rows() > 0) keptSlices.push_back(std::move(slice));
+    }
+
+    // A day without any of the symbols still gets the output schema
+    if (keptSlices.empty()) {
+        ARROW_ASSIGN_OR_RAISE(auto empty, arrow::Table::MakeEmpty(batchReader->schema()));
+        return selectAndScale(empty, params);
+    }
+    return arrow::ConcatenateTables(keptSlices);
+}
+
+arrow::Status writeIndexedDay(const std::shared_ptr<arrow::Table>& table,
+    const std::string& outputPath) {
+    ARROW_ASSIGN_OR_RAISE(auto output, arrow::io::FileOutputStream::Open(outputPath));
+
+    auto writerProperties =
+        parquet::WriterProperties::Builder().compression(parquet::Compression::SNAPPY)->build();
+    // Keep the Arrow schema so timestamp units survive the round trip
+    auto arrowWriterProperties = parquet::ArrowWriterProperties::Builder().store_schema()->build();
+
+    ARROW_RETURN_NOT_OK(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), output,
+        kOutputRowGroupRows, writerProperties, arrowWriterProperties));
+    return output->Close();
+}
+
+/**
+ * @brief Decode a freshly written indexed day and persist it as a quote cache.
+ */
+bool primeQuoteCache(const std::string& indexedPath, const MarketDataParams& params) {
+    QuoteCacheKey key;
+    if (!makeQuoteCacheKey<kIngestDepth>(indexedPath, params, key)) return false;
+
+    std::vector<Quote<kIngestDepth>> quotes;
+    if (!readParquetQuotes<kIngestDepth>(indexedPath, params, quotes)) return false;
+
+    return writeQuoteCache<kIngestDepth>(
+        quoteCachePath<kIngestDepth>(indexedPath, params), key, quotes);
+}
+
+bool hasQuoteCache(const std::string& indexedPath, const MarketDataParams& params) {
+    QuoteCacheKey key;
+    if (!makeQuoteCacheKey<kIngestDepth>(indexedPath, params, key)) return false;
+
+    MappedQuoteFile<kIngestDepth> cache;
+    return cache.open(quoteCachePath<kIngestDepth>(indexedPath, params), key);
+}
+
+}  // namespace
+
+std::string ingestOutputPath(const std::string& inputPath, const IngestParams& params) {
+    const std::filesystem::path input{inputPath};
+    return (std::filesystem::path(params.outputDirectory) /
+               (params.outputPrefix + input.filename().string()))
+        .string();
+}
+
+IngestDayReport ingestDay(const std::string& inputPath, const IngestParams& params) {
+    IngestDayReport report;
+    report.inputPath = inputPath;
+    report.outputPath = ingestOutputPath(inputPath, params);
+
+    const bool withQuoteCache = params.format == IngestFormat::ParquetWithQuoteCache;
+
+    // The cache is primed after the rename, so an existing output may still lack its cache
+    std::error_code error;
+    if (!params.overwrite && std::filesystem::exists(report.outputPath, error)) {
+        if (!withQuoteCache || hasQuoteCache(report.outputPath, params.marketData)) {
+            report.skipped = true;
+            report.succeeded = true;
+            return report;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        report.cacheOnly = true;
+        if (!primeQuoteCache(report.outputPath, params.marketData)) {
+            report.error = "Indexed file exists but its quote cache could not be written";
+            return report;
+        }
+        report.elapsed = std::chrono::steady_clock::now() - start;
+        report.succeeded = true;
+        return report;
+    }
+
+#if ARROW_VERSION_MAJOR >= 21
+    static const bool computeInitialized = arrow::compute::Initialize().ok();
+    if (!computeInitialized) {
+        report.error = "Arrow compute kernels could not be initialized";
+        return report;
+    }
+#endif
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Unique per process and thread so concurrent ingests of the same day never share a
+    // temporary file
+    const std::string temporaryPath = report.outputPath + ".tmp" + std::to_string(::getpid()) +
+        "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    arrow::Status status = [&]() -> arrow::Status {
+        ARROW_ASSIGN_OR_RAISE(auto table, readSelectedRows(inputPath, params, report.rowsRead));
+        ARROW_ASSIGN_OR_RAISE(table, sortRows(table));
+        report.rowsWritten = table->num_rows();
+
+        return writeIndexedDay(table, temporaryPath);
+    }();
+
+    if (!status.ok()) {
+        std::filesystem::remove(temporaryPath, error);
+        report.error = status.ToString();
+        return report;
+    }
+
+    std::filesystem::rename(temporaryPath, report.outputPath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        report.error = "Could not move output into place: " + error.message();
+        return report;
+    }
+
+    if (withQuoteCache && !primeQuoteCache(report.outputPath, params.marketData)) {
+        report.error = "Indexed file written but its quote cache could not be";
+        return report;
+    }
+
+    report.elapsed = std::chrono::steady_clock::now() - start;
+    report.succeeded = true;
+    return report;
+}
+
+std::vector<IngestDayReport> ingestDays(const std::vector<std::string>& inputPaths,
+    const IngestParams& params) {
+    std::vector<IngestDayReport> reports(inputPaths.size());
+
+    std::error_code error;
+    std::filesystem::create_directories(params.outputDirectory, error);
+
+    const std::size_t requestedThreads = (params.threads == 0)
+        ? std::max<std::size_t>(1, std::thread::hardware_concurrency())
+        : params.threads;
+    const std::size_t numberOfThreads = std::min(requestedThreads, inputPaths.size());
+
+    // Days take different amounts of time, so workers pull the next one as they finish
+    std::atomic<std::size_t> nextDay{0};
+    auto work = [&] {
+        for (std::size_t day = nextDay++; day < inputPaths.size(); day = nextDay++) {
+            reports[day] = ingestDay(inputPaths[day], params);
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t thread = 1; thread < numberOfThreads; ++thread) {
+            workers.emplace_back(work);
+        }
+        work();
+    }
+    return reports;
+}
+
+void outputIngestReport(const std::vector<IngestDayReport>& reports,
+    std::chrono::nanoseconds wallTime,
+    std::ostream& out) {
+    auto seconds = [](std::chrono::nanoseconds duration) {
+        return std::chrono::duration<double>(duration).count();
+    };
+
+    out << "\nIngest\n------\n";
+    out << std::left << std::setw(14) << "Rows read" << std::setw(14) << "Rows written"
+        << std::setw(12) << "Time (s)" << std::setw(14) << "Rows/s" << "File" << std::endl;
+
+    std::int64_t totalRowsRead = 0;
+    std::int64_t totalRowsWritten = 0;
+    std::size_t skipped = 0;
+    std::size_t cacheOnly = 0;
+    std::size_t failed = 0;
+    for (const IngestDayReport& report : reports) {
+        if (report.skipped) {
+            ++skipped;
+            out << std::left << std::setw(54) << "skipped, output exists" << report.inputPath
+                << std::endl;
+            continue;
+        }
+        if (report.cacheOnly && report.succeeded) {
+            ++cacheOnly;
+            out << std::left << std::setw(54) << "quote cache written, output exists"
+                << report.inputPath << std::endl;
+            continue;
+        }
+        if (!report.succeeded) {
+            ++failed;
+            out << std::left << std::setw(54) << "failed: " + report.error << report.inputPath
+                << std::endl;
+            continue;
+        }
+
+        const double elapsed = seconds(report.elapsed);
+        out << std::left << std::setw(14) << report.rowsRead << std::setw(14)
+            << report.rowsWritten << std::setw(12) << std::fixed << std::setprecision(2)
+            << elapsed << std::setw(14) << std::setprecision(0)
+            << (elapsed > 0 ? report.rowsRead / elapsed : 0.0) << report.inputPath << std::endl;
+        totalRowsRead += report.rowsRead;
+        totalRowsWritten += report.rowsWritten;
+    }
+
+    const double wallSeconds = seconds(wallTime);
+    out << "Days: " << reports.size() << " (" << skipped << " skipped, " << cacheOnly
+        << " cache only, " << failed << " failed), rows read: " << totalRowsRead
+        << ", rows written: " << totalRowsWritten
+        << ", wall time: " << std::setprecision(2) << wallSeconds << " s";
+    if (wallSeconds > 0) {
+        out << ", " << std::setprecision(0) << totalRowsRead / wallSeconds << " rows/s";
+    }
+    out << std::endl;
+}
+
+}  // namespace sim
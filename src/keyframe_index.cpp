@@ -0,0 +1,142 @@
+// keyframe_index.cpp
+module;
+#include <unistd.h>
+
+module simulation_engine;
+
+import std;
+
+namespace sim {
+
+namespace {
+
+// Bumped whenever the header or the in-memory layout of Keyframe changes
+constexpr std::uint32_t kKeyframeIndexVersion = 2;
+constexpr std::array<char, 8> kKeyframeIndexMagic{'S', 'I', 'M', 'K', 'E', 'Y', 'F', 'R'};
+
+struct KeyframeIndexHeader {
+    std::array<char, 8> magic{kKeyframeIndexMagic};
+    std::uint32_t version{kKeyframeIndexVersion};
+    std::uint32_t numberOfSymbols{0};
+    QuoteCacheKey key{};
+    std::uint64_t keyframeSize{0};
+    std::uint64_t intervalQuotes{0};
+    std::uint64_t intervalNanoseconds{0};
+    std::uint64_t numberOfKeyframes{0};
+};
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool makeHeader(const std::string& sourcePath,
+    const MarketDataParams& params,
+    const KeyframeIndex<depth, numberOfSymbols>& index,
+    KeyframeIndexHeader& header) {
+    if (!makeQuoteCacheKey<depth>(sourcePath, params, header.key)) return false;
+
+    header.numberOfSymbols = numberOfSymbols;
+    header.keyframeSize = sizeof(Keyframe<depth, numberOfSymbols>);
+    header.intervalQuotes = index.intervalQuotes();
+    header.intervalNanoseconds = index.intervalNanoseconds();
+    return true;
+}
+
+bool headersMatch(const KeyframeIndexHeader& a, const KeyframeIndexHeader& b) {
+    return a.magic == b.magic && a.version == b.version &&
+        a.numberOfSymbols == b.numberOfSymbols && a.key.sourcePathHash == b.key.sourcePathHash &&
+        a.key.sourceModifiedTime == b.key.sourceModifiedTime &&
+        a.key.sourceSize == b.key.sourceSize && a.key.symbolFilterHash == b.key.symbolFilterHash &&
+        a.key.depth == b.key.depth && a.key.quoteSize == b.key.quoteSize &&
+        a.keyframeSize == b.keyframeSize && a.intervalQuotes == b.intervalQuotes &&
+        a.intervalNanoseconds == b.intervalNanoseconds;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+std::filesystem::path keyframeIndexPath(const std::string& sourcePath,
+    const MarketDataParams& params) {
+    std::filesystem::path path = quoteCachePath<depth>(sourcePath, params);
+    path.replace_extension(".n" + std::to_string(numberOfSymbols) + ".keyframes");
+    return path;
+}
+
+}  // namespace
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool saveKeyframeIndex(const std::string& sourcePath,
+    const MarketDataParams& params,
+    const KeyframeIndex<depth, numberOfSymbols>& index) {
+    static_assert(std::is_trivially_copyable_v<Keyframe<depth, numberOfSymbols>>);
+
+    KeyframeIndexHeader header;
+    if (!makeHeader(sourcePath, params, index, header)) return false;
+    header.numberOfKeyframes = index.keyframes().size();
+
+    std::error_code error;
+    const std::filesystem::path finalPath = keyframeIndexPath<depth, numberOfSymbols>(sourcePath,
+        params);
+    std::filesystem::create_directories(finalPath.parent_path(), error);
+    if (error) return false;
+
+    // Unique per process and thread so concurrent runs never share a temporary file
+    const std::filesystem::path temporaryPath = finalPath.string() + ".tmp" +
+        std::to_string(::getpid()) + "." +
+        std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(index.keyframes().data()),
+            static_cast<std::streamsize>(index.keyframes().size_bytes()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, finalPath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool loadKeyframeIndex(const std::string& sourcePath,
+    const MarketDataParams& params,
+    KeyframeIndex<depth, numberOfSymbols>& index) {
+    KeyframeIndexHeader expected;
+    if (!makeHeader(sourcePath, params, index, expected)) return false;
+
+    std::ifstream in(keyframeIndexPath<depth, numberOfSymbols>(sourcePath, params),
+        std::ios::binary);
+    if (!in) return false;
+
+    KeyframeIndexHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || !headersMatch(header, expected) || header.numberOfKeyframes == 0) return false;
+
+    std::vector<Keyframe<depth, numberOfSymbols>> keyframes(header.numberOfKeyframes);
+    in.read(reinterpret_cast<char*>(keyframes.data()),
+        static_cast<std::streamsize>(keyframes.size() * sizeof(keyframes.front())));
+    if (!in) return false;
+
+    index.assign(std::move(keyframes));
+    return true;
+}
+
+// Explicit template instantiations
+template bool saveKeyframeIndex<10, 1>(const std::string&,
+    const MarketDataParams&,
+    const KeyframeIndex<10, 1>&);
+template bool saveKeyframeIndex<10, 4>(const std::string&,
+    const MarketDataParams&,
+    const KeyframeIndex<10, 4>&);
+template bool loadKeyframeIndex<10, 1>(const std::string&,
+    const MarketDataParams&,
+    KeyframeIndex<10, 1>&);
+template bool loadKeyframeIndex<10, 4>(const std::string&,
+    const MarketDataParams&,
+    KeyframeIndex<10, 4>&);
+
+}  // namespace sim
@@ -1,8 +1,11 @@
 // market_data.cpp
 module;
 #include <arrow/api.h>
+#include <arrow/compute/api.h>
 #include <arrow/io/api.h>
+#include <arrow/util/config.h>
 #include <parquet/arrow/reader.h>
+#include <parquet/properties.h>
 
 module simulation_engine;
 
@@ -10,118 +13,587 @@ import std;
 
 namespace sim {
 
-template <std::size_t depth, std::uint16_t numberOfSymbols>
-bool MarketDataParquet<depth, numberOfSymbols>::loadData(const std::string& marketDataFilePath) {
-    this->quotes_.clear();
-    arrow::MemoryPool* pool = arrow::default_memory_pool();
+namespace {
 
-    // Open File
-    std::shared_ptr<arrow::io::ReadableFile> input;
-    auto openResult = arrow::io::ReadableFile::Open(marketDataFilePath);
-    if (!openResult.ok()) return false;
-    input = openResult.ValueOrDie();
+// Lower bound on rows per batch so tiny budgets do not degenerate into per-row reads
+constexpr std::int64_t kMinimumBatchRows = 1024;
+
+// Rows converted per thread below which splitting a batch costs more than it saves
+constexpr std::int64_t kMinimumRowsPerTask = 2 * 1024;
+
+std::size_t resolveDecodeThreads(const MarketDataParams& params) {
+    if (params.decodeThreads != 0) return params.decodeThreads;
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
 
-    auto readerResult = parquet::arrow::OpenFile(input, pool);
-    if (!readerResult.ok()) return false;
-    std::unique_ptr<parquet::arrow::FileReader> arrowReader = std::move(readerResult).ValueOrDie();
+std::string levelSuffix(std::size_t level) {
+    return (level < 10) ? "0" + std::to_string(level) : std::to_string(level);
+}
 
-    // Read the Table
-    std::shared_ptr<arrow::Table> table;
-    if (!arrowReader->ReadTable(&table).ok()) return false;
+/**
+ * @brief Names of the only columns the loader reads, in the order they are requested.
+ */
+template <std::size_t depth>
+std::vector<std::string> requiredColumnNames(bool withSymbolId) {
+    std::vector<std::string> names{"rtype", "ts_event"};
+    if (withSymbolId) names.push_back("symbol_id");
+    for (std::size_t level = 0; level < depth; ++level) {
+        const std::string levelIndex = levelSuffix(level);
+        names.push_back("bid_px_" + levelIndex);
+        names.push_back("ask_px_" + levelIndex);
+        names.push_back("bid_sz_" + levelIndex);
+        names.push_back("ask_sz_" + levelIndex);
+    }
+    return names;
+}
 
-    // Ensure all chunks are merged
-    auto combineResult = table->CombineChunks();
-    if (!combineResult.ok()) return false;
-    table = combineResult.ValueOrDie();
+/**
+ * @brief Typed views of the columns needed to build a Quote<depth> from one record batch.
+ */
+template <std::size_t depth>
+struct QuoteColumns {
+    std::shared_ptr<arrow::UInt16Array> symbolId;
+    std::optional<std::uint16_t> symbolIdOverride;  // Replaces the symbol_id column when set
+    std::shared_ptr<arrow::TimestampArray> timestamp;
+    std::int64_t timestampMultiplier{1};
 
-    const std::int64_t numRows = table->num_rows();
-    if (numRows == 0) return true;
-    this->quotes_.reserve(numRows);
+    std::array<std::shared_ptr<arrow::Int64Array>, depth> bidPrice;
+    std::array<std::shared_ptr<arrow::Int64Array>, depth> askPrice;
+    std::array<std::shared_ptr<arrow::UInt32Array>, depth> bidSize;
+    std::array<std::shared_ptr<arrow::UInt32Array>, depth> askSize;
 
-    // Fetch Column Pointers
-    auto rowType =
-        std::static_pointer_cast<arrow::Int8Array>(table->GetColumnByName("rtype")->chunk(0));
+    bool bind(const arrow::RecordBatch& batch) {
+        auto rawTimestamp = batch.GetColumnByName("ts_event");
+        if (!rawTimestamp) return false;
 
-    auto symbolIdColumn =
-        std::static_pointer_cast<arrow::UInt16Array>(table->GetColumnByName("symbol_id")->chunk(0));
+        if (!symbolIdOverride) {
+            auto rawSymbolId = batch.GetColumnByName("symbol_id");
+            if (!rawSymbolId) return false;
+            symbolId = std::static_pointer_cast<arrow::UInt16Array>(rawSymbolId);
+        }
+        timestamp = std::static_pointer_cast<arrow::TimestampArray>(rawTimestamp);
 
-    auto rawTimestampColumn = table->GetColumnByName("ts_event");
-    auto timestampColumn =
-        std::static_pointer_cast<arrow::TimestampArray>(rawTimestampColumn->chunk(0));
+        // Determine scaling for timestamps
+        auto timestampType = std::static_pointer_cast<arrow::TimestampType>(rawTimestamp->type());
+        timestampMultiplier = (timestampType->unit() == arrow::TimeUnit::MICRO) ? 1000 : 1;
 
-    // Determine scaling for timestamps
-    auto timestampType = std::static_pointer_cast<arrow::TimestampType>(rawTimestampColumn->type());
-    int64_t timestampMultiplier = (timestampType->unit() == arrow::TimeUnit::MICRO) ? 1000 : 1;
+        for (std::size_t level = 0; level < depth; ++level) {
+            const std::string levelIndex = levelSuffix(level);
 
-    // Pre-fetch Level-based Column Pointers
-    std::array<std::shared_ptr<arrow::Int64Array>, depth> bidPriceColumn;
-    std::array<std::shared_ptr<arrow::Int64Array>, depth> askPriceColumn;
-    std::array<std::shared_ptr<arrow::UInt32Array>, depth> bidSizeColumn;
-    std::array<std::shared_ptr<arrow::UInt32Array>, depth> askSizeColumn;
+            auto rawBidPrice = batch.GetColumnByName("bid_px_" + levelIndex);
+            auto rawAskPrice = batch.GetColumnByName("ask_px_" + levelIndex);
+            auto rawBidSize = batch.GetColumnByName("bid_sz_" + levelIndex);
+            auto rawAskSize = batch.GetColumnByName("ask_sz_" + levelIndex);
+            if (!rawBidPrice || !rawAskPrice || !rawBidSize || !rawAskSize) return false;
 
-    for (std::size_t level = 0; level < depth; ++level) {
-        std::string levelIndex = (level < 10) ? "0" + std::to_string(level) : std::to_string(level);
+            bidPrice[level] = std::static_pointer_cast<arrow::Int64Array>(rawBidPrice);
+            askPrice[level] = std::static_pointer_cast<arrow::Int64Array>(rawAskPrice);
+            bidSize[level] = std::static_pointer_cast<arrow::UInt32Array>(rawBidSize);
+            askSize[level] = std::static_pointer_cast<arrow::UInt32Array>(rawAskSize);
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Drop unusable rows from a record batch with vectorized compute kernels.
+ * @details Keeps rows with rtype == depth, a positive level-one bid below the level-one ask and,
+ * when a symbol set is given, a symbol_id inside it.
+ * @param batch The projected record batch.
+ * @param symbolSet Array of symbol ids to keep, or null to keep every symbol.
+ * @return The filtered batch, sharing no rows with the dropped ones.
+ */
+template <std::size_t depth>
+arrow::Result<std::shared_ptr<arrow::RecordBatch>> filterRows(
+    const std::shared_ptr<arrow::RecordBatch>& batch,
+    const std::shared_ptr<arrow::Array>& symbolSet) {
+    namespace compute = arrow::compute;
 
-        bidPriceColumn[level] = std::static_pointer_cast<arrow::Int64Array>(
-            table->GetColumnByName("bid_px_" + levelIndex)->chunk(0));
-        askPriceColumn[level] = std::static_pointer_cast<arrow::Int64Array>(
-            table->GetColumnByName("ask_px_" + levelIndex)->chunk(0));
-        bidSizeColumn[level] = std::static_pointer_cast<arrow::UInt32Array>(
-            table->GetColumnByName("bid_sz_" + levelIndex)->chunk(0));
-        askSizeColumn[level] = std::static_pointer_cast<arrow::UInt32Array>(
-            table->GetColumnByName("ask_sz_" + levelIndex)->chunk(0));
+    auto rowType = batch->GetColumnByName("rtype");
+    auto levelOneBid = batch->GetColumnByName("bid_px_00");
+    auto levelOneAsk = batch->GetColumnByName("ask_px_00");
+    if (!rowType || !levelOneBid || !levelOneAsk) {
+        return arrow::Status::Invalid("Market data batch is missing a filter column");
     }
 
-    // Main Processing Loop
-    for (std::int64_t row = 0; row < numRows; ++row) {
-        if (rowType->Value(row) != depth) continue;
+    ARROW_ASSIGN_OR_RAISE(auto depthScalar,
+        arrow::MakeScalar(rowType->type(), static_cast<std::int64_t>(depth)));
+    ARROW_ASSIGN_OR_RAISE(auto zeroScalar, arrow::MakeScalar(levelOneBid->type(), 0));
 
-        std::int64_t levelOneBid = bidPriceColumn[0]->Value(row);
-        std::int64_t levelOneAsk = askPriceColumn[0]->Value(row);
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum keep,
+        compute::CallFunction("equal", {rowType, arrow::Datum(depthScalar)}));
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum uncrossed,
+        compute::CallFunction("less", {levelOneBid, levelOneAsk}));
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum positiveBid,
+        compute::CallFunction("greater", {levelOneBid, arrow::Datum(zeroScalar)}));
 
-        if (levelOneBid >= levelOneAsk || levelOneBid <= 0) {
-            continue;
-        }
+    ARROW_ASSIGN_OR_RAISE(keep, compute::And(keep, uncrossed));
+    ARROW_ASSIGN_OR_RAISE(keep, compute::And(keep, positiveBid));
 
-        Quote<depth> quote;
+    if (symbolSet) {
+        compute::SetLookupOptions lookupOptions(symbolSet);
+        ARROW_ASSIGN_OR_RAISE(arrow::Datum inUniverse,
+            compute::CallFunction("is_in", {batch->GetColumnByName("symbol_id")}, &lookupOptions));
+        ARROW_ASSIGN_OR_RAISE(keep, compute::And(keep, inUniverse));
+    }
 
-        quote.symbolId = symbolIdColumn->Value(row);
-        quote.timestamp = TimeStamp{
-            static_cast<std::uint64_t>(timestampColumn->Value(row) * timestampMultiplier)};
+    ARROW_ASSIGN_OR_RAISE(arrow::Datum filtered, compute::Filter(batch, keep));
+    return filtered.record_batch();
+}
 
-        for (std::size_t level = 0; level < depth; ++level) {
-            std::int64_t rawBid = bidPriceColumn[level]->Value(row);
-            std::int64_t rawAsk = askPriceColumn[level]->Value(row);
+/**
+ * @brief Convert rows [firstRow, lastRow) of a bound batch into the quotes starting at quotes.
+ */
+template <std::size_t depth>
+void convertRows(const QuoteColumns<depth>& columns,
+    std::int64_t firstRow,
+    std::int64_t lastRow,
+    Quote<depth>* quotes) {
+    for (std::int64_t row = firstRow; row < lastRow; ++row) {
+        Quote<depth>& quote = quotes[row - firstRow];
 
-            quote.prices[level] = Ticks{rawBid};
-            quote.prices[depth + level] = Ticks{rawAsk};
-            quote.sizes[level] = Ticks{static_cast<std::int64_t>(bidSizeColumn[level]->Value(row))};
+        quote.symbolId =
+            columns.symbolIdOverride ? *columns.symbolIdOverride : columns.symbolId->Value(row);
+        quote.timestamp = TimeStamp{static_cast<std::uint64_t>(
+            columns.timestamp->Value(row) * columns.timestampMultiplier)};
+
+        for (std::size_t level = 0; level < depth; ++level) {
+            quote.prices[level] = Ticks{columns.bidPrice[level]->Value(row)};
+            quote.prices[depth + level] = Ticks{columns.askPrice[level]->Value(row)};
+            quote.sizes[level] =
+                Ticks{static_cast<std::int64_t>(columns.bidSize[level]->Value(row))};
             quote.sizes[depth + level] =
-                Ticks{static_cast<std::int64_t>(askSizeColumn[level]->Value(row))};
+                Ticks{static_cast<std::int64_t>(columns.askSize[level]->Value(row))};
         }
+    }
+}
+
+/**
+ * @brief Convert the rows of one filtered record batch into quotes, appending them to the buffer.
+ * @details With more than one thread the rows are split into one contiguous chunk per thread,
+ * each converted into its own slice of the buffer, so the quotes keep the order of the file. The
+ * calling thread converts the first chunk and a short-lived thread each of the others, which
+ * keeps the fan-out to exactly the threads the reader was given.
+ */
+template <std::size_t depth>
+bool appendQuotes(const arrow::RecordBatch& batch,
+    std::optional<std::uint16_t> symbolIdOverride,
+    std::size_t numberOfThreads,
+    std::vector<Quote<depth>>& out) {
+    QuoteColumns<depth> columns;
+    columns.symbolIdOverride = symbolIdOverride;
+    if (!columns.bind(batch)) return false;
 
-        this->quotes_.push_back(std::move(quote));
+    const std::int64_t numRows = batch.num_rows();
+    const std::size_t firstQuote = out.size();
+    out.resize(firstQuote + static_cast<std::size_t>(numRows));
+    Quote<depth>* quotes = out.data() + firstQuote;
+
+    const std::int64_t numberOfChunks = std::clamp<std::int64_t>(
+        numRows / kMinimumRowsPerTask, 1, static_cast<std::int64_t>(numberOfThreads));
+    if (numberOfChunks == 1) {
+        convertRows(columns, 0, numRows, quotes);
+        return true;
     }
 
+    const std::int64_t rowsPerChunk = (numRows + numberOfChunks - 1) / numberOfChunks;
+    auto convertChunk = [&columns, numRows, rowsPerChunk, quotes](std::int64_t chunk) {
+        const std::int64_t firstRow = chunk * rowsPerChunk;
+        const std::int64_t lastRow = std::min(numRows, firstRow + rowsPerChunk);
+        convertRows(columns, firstRow, lastRow, quotes + firstRow);
+    };
+
+    // The workers are joined when they go out of scope, before the batch's columns are
+    std::vector<std::jthread> workers;
+    workers.reserve(static_cast<std::size_t>(numberOfChunks - 1));
+    for (std::int64_t chunk = 1; chunk < numberOfChunks; ++chunk) {
+        workers.emplace_back(convertChunk, chunk);
+    }
+    convertChunk(0);
     return true;
 }
 
+}  // namespace
+
+template <std::size_t depth>
+struct ParquetQuoteReader<depth>::State {
+    std::shared_ptr<arrow::io::ReadableFile> input;
+    std::unique_ptr<parquet::arrow::FileReader> fileReader;
+    std::unique_ptr<arrow::RecordBatchReader> batchReader;
+    std::shared_ptr<arrow::Array> symbolSet;
+    std::optional<std::uint16_t> symbolIdOverride;
+    std::int64_t numberOfRows{0};
+    std::int64_t batchSize{0};
+    std::size_t decodeThreads{1};
+};
+
+template <std::size_t depth>
+ParquetQuoteReader<depth>::ParquetQuoteReader(const MarketDataParams& params) : params_(params) {}
+
+template <std::size_t depth>
+ParquetQuoteReader<depth>::~ParquetQuoteReader() = default;
+
+template <std::size_t depth>
+ParquetQuoteReader<depth>::ParquetQuoteReader(ParquetQuoteReader&& other) noexcept = default;
+
+template <std::size_t depth>
+ParquetQuoteReader<depth>& ParquetQuoteReader<depth>::operator=(
+    ParquetQuoteReader&& other) noexcept = default;
+
+template <std::size_t depth>
+bool ParquetQuoteReader<depth>::open(const std::string& marketDataFilePath) {
+    return openFile(marketDataFilePath, std::nullopt);
+}
+
+template <std::size_t depth>
+bool ParquetQuoteReader<depth>::open(const std::string& marketDataFilePath,
+    std::uint16_t symbolId) {
+    return openFile(marketDataFilePath, symbolId);
+}
+
+template <std::size_t depth>
+bool ParquetQuoteReader<depth>::openFile(const std::string& marketDataFilePath,
+    std::optional<std::uint16_t> symbolIdOverride) {
+    close();
+    error_.clear();
+    auto state = std::make_unique<State>();
+    state->symbolIdOverride = symbolIdOverride;
+
+#if ARROW_VERSION_MAJOR >= 21
+    // Compute kernels live in their own library and must be registered before first use
+    static const bool computeInitialized = arrow::compute::Initialize().ok();
+    if (!computeInitialized) return false;
+#endif
+
+    // Each row costs its Arrow columns (~ one Quote worth of bytes) plus the decoded Quote itself
+    const std::int64_t bytesPerRow = 2 * static_cast<std::int64_t>(sizeof(Quote<depth>));
+    state->decodeThreads = resolveDecodeThreads(params_);
+    // A batch gives every decode thread at least one conversion task, even past the budget
+    const std::int64_t minimumBatchRows = std::max(kMinimumBatchRows,
+        static_cast<std::int64_t>(state->decodeThreads) * kMinimumRowsPerTask);
+    state->batchSize = std::max(minimumBatchRows,
+        static_cast<std::int64_t>(params_.memoryBudgetBytes) / bytesPerRow);
+
+    // Open File
+    auto openResult = arrow::io::ReadableFile::Open(marketDataFilePath);
+    if (!openResult.ok()) return false;
+    state->input = openResult.ValueOrDie();
+
+    // Buffered page reads keep the I/O footprint to one buffer per column instead of whole
+    // column chunks
+    parquet::ReaderProperties readerProperties = parquet::default_reader_properties();
+    readerProperties.enable_buffered_stream();
+
+    parquet::ArrowReaderProperties arrowProperties = parquet::default_arrow_reader_properties();
+    arrowProperties.set_batch_size(state->batchSize);
+
+    if (state->decodeThreads > 1) {
+        // Columns are decoded on Arrow's process-wide CPU pool, which is left at the size the
+        // application gave it; rows are converted on the reader's own threads
+        arrowProperties.set_use_threads(true);
+
+        // Coalesced reads ahead of decoding would hold whole row groups, so streaming runs
+        // keep to the memory budget instead
+        if (!params_.streaming) {
+            arrowProperties.set_pre_buffer(true);
+        }
+    }
+
+    parquet::arrow::FileReaderBuilder builder;
+    if (!builder.Open(state->input, readerProperties).ok()) return false;
+    builder.memory_pool(arrow::default_memory_pool());
+    builder.properties(arrowProperties);
+    if (!builder.Build(&state->fileReader).ok()) return false;
+
+    state->numberOfRows = state->fileReader->parquet_reader()->metadata()->num_rows();
+
+    // Project onto the columns the quotes are built from; everything else is never decoded
+    const auto fileSchema = state->fileReader->parquet_reader()->metadata()->schema();
+    std::vector<int> columnIndices;
+    for (const std::string& columnName : requiredColumnNames<depth>(!symbolIdOverride)) {
+        const int columnIndex = fileSchema->ColumnIndex(columnName);
+        if (columnIndex < 0) return false;
+        columnIndices.push_back(columnIndex);
+    }
+
+    if (!params_.symbolIds.empty() && !symbolIdOverride) {
+        arrow::UInt16Builder symbolSetBuilder;
+        if (!symbolSetBuilder.AppendValues(params_.symbolIds).ok()) return false;
+        auto symbolSetResult = symbolSetBuilder.Finish();
+        if (!symbolSetResult.ok()) return false;
+        state->symbolSet = symbolSetResult.ValueOrDie();
+    }
+
+    std::vector<int> rowGroups(state->fileReader->num_row_groups());
+    std::iota(rowGroups.begin(), rowGroups.end(), 0);
+
+    auto batchReaderResult = state->fileReader->GetRecordBatchReader(rowGroups, columnIndices);
+    if (!batchReaderResult.ok()) return false;
+    state->batchReader = std::move(batchReaderResult).ValueOrDie();
+
+    state_ = std::move(state);
+    return true;
+}
+
+template <std::size_t depth>
+ReadStatus ParquetQuoteReader<depth>::readNext(std::vector<Quote<depth>>& out) {
+    if (!state_) return error_.empty() ? ReadStatus::EndOfFile : ReadStatus::Error;
+
+    std::shared_ptr<arrow::RecordBatch> batch;
+    const arrow::Status readStatus = state_->batchReader->ReadNext(&batch);
+    if (!readStatus.ok()) return fail(readStatus.ToString());
+    if (!batch) {
+        close();
+        return ReadStatus::EndOfFile;
+    }
+
+    auto filterResult = filterRows<depth>(batch, state_->symbolSet);
+    if (!filterResult.ok()) return fail(filterResult.status().ToString());
+    if (!appendQuotes<depth>(**filterResult, state_->symbolIdOverride, state_->decodeThreads,
+            out)) {
+        return fail("Record batch is missing a quote column or could not be converted");
+    }
+    return ReadStatus::Batch;
+}
+
+template <std::size_t depth>
+ReadStatus ParquetQuoteReader<depth>::readNext(QuoteBuffer<depth>& out) {
+    if (out.layout() == QuoteLayout::Rows) return readNext(out.rows());
+
+    staging_.clear();
+    const ReadStatus status = readNext(staging_);
+    out.append(staging_);
+    return status;
+}
+
+template <std::size_t depth>
+ReadStatus ParquetQuoteReader<depth>::fail(std::string message) {
+    close();
+    error_ = std::move(message);
+    return ReadStatus::Error;
+}
+
+template <std::size_t depth>
+std::int64_t ParquetQuoteReader<depth>::numberOfRows() const {
+    return state_ ? state_->numberOfRows : 0;
+}
+
+template <std::size_t depth>
+std::int64_t ParquetQuoteReader<depth>::batchSize() const {
+    return state_ ? state_->batchSize : 0;
+}
+
+template <std::size_t depth>
+void ParquetQuoteReader<depth>::close() {
+    state_.reset();
+}
+
+template <std::size_t depth>
+bool readParquetQuotes(const std::string& marketDataFilePath,
+    const MarketDataParams& params,
+    std::vector<Quote<depth>>& out) {
+    out.clear();
+
+    ParquetQuoteReader<depth> reader(params);
+    if (!reader.open(marketDataFilePath)) return false;
+
+    out.reserve(reader.numberOfRows());
+    ReadStatus status = ReadStatus::Batch;
+    while (status == ReadStatus::Batch) {
+        status = reader.readNext(out);
+    }
+    return status == ReadStatus::EndOfFile;
+}
+
+template <std::size_t depth>
+bool readParquetQuotes(const std::string& marketDataFilePath,
+    const MarketDataParams& params,
+    QuoteBuffer<depth>& out) {
+    out.clear();
+
+    ParquetQuoteReader<depth> reader(params);
+    if (!reader.open(marketDataFilePath)) return false;
+
+    out.reserve(reader.numberOfRows());
+    ReadStatus status = ReadStatus::Batch;
+    while (status == ReadStatus::Batch) {
+        status = reader.readNext(out);
+    }
+    return status == ReadStatus::EndOfFile;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool MarketDataParquet<depth, numberOfSymbols>::loadData(const std::string& marketDataFilePath) {
+    if (!this->params_.streaming) {
+        return readParquetQuotes<depth>(marketDataFilePath, this->params_, this->quotes_);
+    }
+
+    // Streaming mode: keep the reader open and hold only one batch of quotes at a time
+    this->quotes_.clear();
+    if (!reader_.open(marketDataFilePath)) return false;
+    this->quotes_.reserve(reader_.batchSize());
+    return loadNextBatch() || !this->loadFailed();
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool MarketDataParquet<depth, numberOfSymbols>::loadNextBatch() {
+    // The buffer's capacity is reused from batch to batch, so it behaves as a fixed ring
+    this->quotes_.clear();
+    ReadStatus status = ReadStatus::Batch;
+    while (this->quotes_.empty() && status == ReadStatus::Batch) {
+        status = reader_.readNext(this->quotes_);
+    }
+    if (status == ReadStatus::Error) {
+        this->recordLoadError("Could not decode " + this->currentFilePath() + ": " +
+            reader_.error());
+    }
+    return !this->quotes_.empty();
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+typename MarketDataParquet<depth, numberOfSymbols>::QuoteFileDecoder
+MarketDataParquet<depth, numberOfSymbols>::fileDecoder() const {
+    // Streaming files are decoded batch by batch on the simulation thread instead
+    if (this->params_.streaming) return {};
+
+    return [params = this->params_](const std::string& marketDataFilePath,
+               QuoteBuffer<depth>& out) {
+        return readParquetQuotes<depth>(marketDataFilePath, params, out);
+    };
+}
+
 template <std::size_t depth, std::uint16_t numberOfSymbols>
 bool MarketDataParquet<depth, numberOfSymbols>::loadData() {
     if (!this->multipleFiles_) {
-        loadData(this->marketDataFilePath_);
-        return true;
+        return loadData(this->marketDataFilePath_);
     }
 
     if (this->currentFileIndex >= this->marketDataFilePaths_.size()) {
         return false;
     }
-    loadData(this->marketDataFilePaths_[this->currentFileIndex]);
+    return loadData(this->marketDataFilePaths_[this->currentFileIndex]);
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+ReadStatus MarketDataMerged<depth, numberOfSymbols>::Source::refill() {
+    buffer.clear();
+    cursor = 0;
+    ReadStatus status = ReadStatus::Batch;
+    while (buffer.empty() && status == ReadStatus::Batch) {
+        status = reader.readNext(buffer);
+    }
+    return buffer.empty() ? status : ReadStatus::Batch;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool MarketDataMerged<depth, numberOfSymbols>::openDay(std::size_t day) {
+    const std::vector<std::string>& filePaths = symbolFilePathsPerDay_[day];
+    if (filePaths.size() > numberOfSymbols) {
+        this->recordLoadError("Day " + std::to_string(day) + " has " +
+            std::to_string(filePaths.size()) + " files for " + std::to_string(numberOfSymbols) +
+            " symbols");
+        return false;
+    }
+
+    // Every reader and the merged batch get an equal share of the budget
+    MarketDataParams readerParams = this->params_;
+    readerParams.memoryBudgetBytes = this->params_.memoryBudgetBytes / (filePaths.size() + 1);
+
+    sources_.clear();
+    heap_.clear();
+    sources_.reserve(filePaths.size());
+    for (std::size_t symbol = 0; symbol < filePaths.size(); ++symbol) {
+        Source& source = sources_.emplace_back(Source{ParquetQuoteReader<depth>(readerParams)});
+        if (!source.reader.open(filePaths[symbol], static_cast<std::uint16_t>(symbol))) {
+            this->recordLoadError("Could not open " + filePaths[symbol]);
+            return false;
+        }
+        batchSize_ = std::max(batchSize_, static_cast<std::size_t>(source.reader.batchSize()));
+        source.buffer.reserve(static_cast<std::size_t>(source.reader.batchSize()));
+        switch (source.refill()) {
+            case ReadStatus::Batch:
+                heap_.push_back(symbol);
+                break;
+            case ReadStatus::EndOfFile:
+                break;
+            case ReadStatus::Error:
+                this->recordLoadError(
+                    "Could not decode " + filePaths[symbol] + ": " + source.reader.error());
+                return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool MarketDataMerged<depth, numberOfSymbols>::loadNextBatch() {
+    // Min-heap on the head quote of each source; symbol ids are unique per source, so
+    // (timestamp, symbol id) is a total order and ties resolve exactly like ORDER BY does
+    auto later = [this](std::size_t a, std::size_t b) {
+        const Quote<depth>& quoteA = sources_[a].head();
+        const Quote<depth>& quoteB = sources_[b].head();
+        if (quoteA.timestamp != quoteB.timestamp) return quoteB.timestamp < quoteA.timestamp;
+        return quoteB.symbolId < quoteA.symbolId;
+    };
+
+    this->quotes_.clear();
+    if (this->loadFailed()) return false;
+
+    while (this->quotes_.empty()) {
+        if (!dayOpen_ || heap_.empty()) {
+            if (dayOpen_) ++currentDay_;
+            if (currentDay_ >= symbolFilePathsPerDay_.size()) return false;
+
+            dayOpen_ = true;
+            // A day that cannot be opened ends the stream rather than leaving a gap in it
+            if (!openDay(currentDay_)) {
+                heap_.clear();
+                return false;
+            }
+            std::make_heap(heap_.begin(), heap_.end(), later);
+            this->quotes_.reserve(batchSize_);
+        }
+
+        while (!heap_.empty() && this->quotes_.size() < batchSize_) {
+            std::pop_heap(heap_.begin(), heap_.end(), later);
+            Source& source = sources_[heap_.back()];
+            this->quotes_.push_back(source.head());
+
+            if (++source.cursor < source.buffer.size()) {
+                std::push_heap(heap_.begin(), heap_.end(), later);
+                continue;
+            }
+            switch (source.refill()) {
+                case ReadStatus::Batch:
+                    std::push_heap(heap_.begin(), heap_.end(), later);
+                    break;
+                case ReadStatus::EndOfFile:
+                    heap_.pop_back();
+                    break;
+                case ReadStatus::Error:
+                    // The quotes merged so far come before the failure and are still delivered
+                    this->recordLoadError("Could not decode " +
+                        symbolFilePathsPerDay_[currentDay_][heap_.back()] + ": " +
+                        source.reader.error());
+                    heap_.clear();
+                    return !this->quotes_.empty();
+            }
+        }
+    }
     return true;
 }
 
 // Explicit template instantiations
+template class ParquetQuoteReader<10>;
+template bool readParquetQuotes<10>(const std::string&,
+    const MarketDataParams&,
+    std::vector<Quote<10>>&);
+template bool readParquetQuotes<10>(const std::string&,
+    const MarketDataParams&,
+    QuoteBuffer<10>&);
 template class MarketDataParquet<10, 1>;
 template class MarketDataParquet<10, 4>;
+template class MarketDataMerged<10, 1>;
+template class MarketDataMerged<10, 4>;
 
 }  // namespace sim
@@ -11,6 +11,8 @@ void Portfolio<numberOfSymbols, Distribution>::updatePortfolio(const Fill& fill)
     const Quantity fillQuantity = fill.quantity;
     const Ticks fillPrice = fill.price;
     const Ticks totalNotional = fillPrice * fillQuantity;
+    const Quantity previousLong = longQuantity[symbolId];
+    const Quantity previousShort = shortQuantity[symbolId];
 
     if (fill.instruction == OrderInstruction::Buy) {
         // A Buy consumes cash immediately.
@@ -69,12 +71,65 @@ void Portfolio<numberOfSymbols, Distribution>::updatePortfolio(const Fill& fill)
             shortQuantity[symbolId] += quantityToOpen;
         }
     }
+
+    revaluePosition(symbolId, previousLong, previousShort);
+}
+
+template <std::uint16_t numberOfSymbols, typename Distribution>
+void Portfolio<numberOfSymbols, Distribution>::revaluePosition(std::uint16_t symbolId,
+    Quantity previousLong,
+    Quantity previousShort) {
+    const std::int64_t longChange = static_cast<std::int64_t>(longQuantity[symbolId].value()) -
+        static_cast<std::int64_t>(previousLong.value());
+    const std::int64_t shortChange = static_cast<std::int64_t>(shortQuantity[symbolId].value()) -
+        static_cast<std::int64_t>(previousShort.value());
+
+    longMarketValue_ += markBids_[symbolId] * longChange;
+    shortMarketValue_ += markAsks_[symbolId] * shortChange;
+}
+
+template <std::uint16_t numberOfSymbols, typename Distribution>
+void Portfolio<numberOfSymbols, Distribution>::markToMarket(std::uint16_t symbolId,
+    Ticks bestBid,
+    Ticks bestAsk) {
+    const auto longPosition = static_cast<std::int64_t>(longQuantity[symbolId].value());
+    const auto shortPosition = static_cast<std::int64_t>(shortQuantity[symbolId].value());
+
+    longMarketValue_ += (bestBid - markBids_[symbolId]) * longPosition;
+    shortMarketValue_ += (bestAsk - markAsks_[symbolId]) * shortPosition;
+    markBids_[symbolId] = bestBid;
+    markAsks_[symbolId] = bestAsk;
+}
+
+template <std::uint16_t numberOfSymbols, typename Distribution>
+void Portfolio<numberOfSymbols, Distribution>::save(SnapshotWriter& out) const {
+    out.write(cash);
+    out.write(settledFunds);
+    out.write(longQuantity);
+    out.write(shortQuantity);
+    out.write(costBasis);
+    out.write(loan);
+    out.write(interestOwed);
+    out.write(interestRate);
+    out.write(pendingFunds_);
+    out.write(markBids_);
+    out.write(markAsks_);
+    out.write(longMarketValue_);
+    out.write(shortMarketValue_);
+}
+
+template <std::uint16_t numberOfSymbols, typename Distribution>
+bool Portfolio<numberOfSymbols, Distribution>::load(SnapshotReader& in) {
+    return in.read(cash) && in.read(settledFunds) && in.read(longQuantity) &&
+        in.read(shortQuantity) && in.read(costBasis) && in.read(loan) && in.read(interestOwed) &&
+        in.read(interestRate) && in.read(pendingFunds_) && in.read(markBids_) &&
+        in.read(markAsks_) && in.read(longMarketValue_) && in.read(shortMarketValue_);
 }
 
 template <std::uint16_t numberOfSymbols, typename Distribution>
 Ticks Portfolio<numberOfSymbols, Distribution>::grossMarketValue(
-    const std::array<Ticks, numberOfSymbols>& bestBids,
-    const std::array<Ticks, numberOfSymbols>& bestAsks) const {
+    std::span<const Ticks, numberOfSymbols> bestBids,
+    std::span<const Ticks, numberOfSymbols> bestAsks) const {
     Ticks currentLongMarketValue = longMarketValue(bestBids);
     Ticks currentShortMarketValue = shortMarketValue(bestAsks);
 
@@ -83,8 +138,8 @@ Ticks Portfolio<numberOfSymbols, Distribution>::grossMarketValue(
 
 template <std::uint16_t numberOfSymbols, typename Distribution>
 Ticks Portfolio<numberOfSymbols, Distribution>::netMarketValue(
-    const std::array<Ticks, numberOfSymbols>& bestBids,
-    const std::array<Ticks, numberOfSymbols>& bestAsks) const {
+    std::span<const Ticks, numberOfSymbols> bestBids,
+    std::span<const Ticks, numberOfSymbols> bestAsks) const {
     Ticks currentLongMarketValue = longMarketValue(bestBids);
     Ticks currentShortMarketValue = shortMarketValue(bestAsks);
 
@@ -93,8 +148,8 @@ Ticks Portfolio<numberOfSymbols, Distribution>::netMarketValue(
 
 template <std::uint16_t numberOfSymbols, typename Distribution>
 Ticks Portfolio<numberOfSymbols, Distribution>::netLiquidationValue(
-    const std::array<Ticks, numberOfSymbols>& bestBids,
-    const std::array<Ticks, numberOfSymbols>& bestAsks) const {
+    std::span<const Ticks, numberOfSymbols> bestBids,
+    std::span<const Ticks, numberOfSymbols> bestAsks) const {
     Ticks currentNetMarketValue = netMarketValue(bestBids, bestAsks);
 
     return cash + currentNetMarketValue - (loan + interestOwed);
@@ -102,7 +157,7 @@ Ticks Portfolio<numberOfSymbols, Distribution>::netLiquidationValue(
 
 template <std::uint16_t numberOfSymbols, typename Distribution>
 Ticks Portfolio<numberOfSymbols, Distribution>::longMarketValue(
-    const std::array<Ticks, numberOfSymbols>& bestBids) const {
+    std::span<const Ticks, numberOfSymbols> bestBids) const {
     // Perform inner produce on bestBids and longQuantity to get the marketValue of the long
     // positions Note: This could be more accurate by accounting for numher of shares at each level,
     // but since this method is not used in the core logic of fills, we simplify it here.
@@ -113,7 +168,7 @@ Ticks Portfolio<numberOfSymbols, Distribution>::longMarketValue(
 
 template <std::uint16_t numberOfSymbols, typename Distribution>
 Ticks Portfolio<numberOfSymbols, Distribution>::shortMarketValue(
-    const std::array<Ticks, numberOfSymbols>& bestAsks) const {
+    std::span<const Ticks, numberOfSymbols> bestAsks) const {
     // Perform inner produce on bestBids and longQuantity to get the marketValue of the long
     // positions Note: This could be more accurate by accounting for numher of shares at each level,
     // but since this method is not used in the core logic of fills, we simplify it here.
@@ -180,8 +235,8 @@ void Portfolio<numberOfSymbols, Distribution>::calculateDailyInterest(TimeStamp
 
 template <std::uint16_t numberOfSymbols, typename Distribution>
 Ticks Portfolio<numberOfSymbols, Distribution>::maintenanceRequirement(
-    const std::array<Ticks, numberOfSymbols>& bestBids,
-    const std::array<Ticks, numberOfSymbols>& bestAsks) const {
+    std::span<const Ticks, numberOfSymbols> bestBids,
+    std::span<const Ticks, numberOfSymbols> bestAsks) const {
     Ticks grossValue = this->grossMarketValue(bestBids, bestAsks);
     return grossValue * 3 / 10;  // 30%
 }
@@ -231,8 +286,8 @@ void Portfolio<numberOfSymbols, Distribution>::processSettlements(TimeStamp curr
 
 template <std::uint16_t numberOfSymbols, typename Distribution>
 bool Portfolio<numberOfSymbols, Distribution>::violatesMarginRequirement(
-    const std::array<Ticks, numberOfSymbols>& bestBids,
-    const std::array<Ticks, numberOfSymbols>& bestAsks) const {
+    std::span<const Ticks, numberOfSymbols> bestBids,
+    std::span<const Ticks, numberOfSymbols> bestAsks) const {
     Ticks currentEquity = netLiquidationValue(bestBids, bestAsks);
     Ticks maintenanceReq = maintenanceRequirement(bestBids, bestAsks);
     if (currentEquity < maintenanceReq) {
@@ -243,16 +298,30 @@ bool Portfolio<numberOfSymbols, Distribution>::violatesMarginRequirement(
 
 template <std::uint16_t numberOfSymbols, typename Distribution>
 bool Portfolio<numberOfSymbols, Distribution>::sufficientEquityForOrder(
-    const std::array<Ticks, numberOfSymbols>& bestBids,
-    const std::array<Ticks, numberOfSymbols>& bestAsks,
+    std::span<const Ticks, numberOfSymbols> bestBids,
+    std::span<const Ticks, numberOfSymbols> bestAsks,
     const NewOrder& order,
     Ticks totalOrderPrice,
     double leverageFactor) const {
-    const std::uint16_t symbolId = order.symbol;
+    return sufficientEquityForOrder(order, totalOrderPrice, leverageFactor,
+        netLiquidationValue(bestBids, bestAsks), grossMarketValue(bestBids, bestAsks));
+}
 
-    // Calculate Current State
-    const Ticks currentNetLiquidationValue = netLiquidationValue(bestBids, bestAsks);
-    const Ticks currentGrossMarketValue = grossMarketValue(bestBids, bestAsks);
+template <std::uint16_t numberOfSymbols, typename Distribution>
+bool Portfolio<numberOfSymbols, Distribution>::sufficientEquityForOrder(const NewOrder& order,
+    Ticks totalOrderPrice,
+    double leverageFactor) const {
+    return sufficientEquityForOrder(order, totalOrderPrice, leverageFactor, netLiquidationValue(),
+        grossMarketValue());
+}
+
+template <std::uint16_t numberOfSymbols, typename Distribution>
+bool Portfolio<numberOfSymbols, Distribution>::sufficientEquityForOrder(const NewOrder& order,
+    Ticks totalOrderPrice,
+    double leverageFactor,
+    Ticks currentNetLiquidationValue,
+    Ticks currentGrossMarketValue) const {
+    const std::uint16_t symbolId = order.symbol;
 
     // Quantity Netting
     const Quantity totalQuantity = order.quantity;
@@ -304,5 +373,9 @@ void Portfolio<numberOfSymbols, Distribution>::updateCostBasis(std::uint16_t sym
 // Explicit template instantiations
 template class Portfolio<1, ConstantDistribution>;
 template class Portfolio<4, ConstantDistribution>;
+template class Portfolio<1, BetaDistribution>;
+template class Portfolio<4, BetaDistribution>;
+template class Portfolio<1, AnyDistribution>;
+template class Portfolio<4, AnyDistribution>;
 
 }  // namespace sim
@@ -0,0 +1,266 @@
+// quote_cache.cpp
+module;
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+module simulation_engine;
+
+import std;
+
+namespace sim {
+
+namespace {
+
+// Bumped whenever the header or the in-memory layout of Quote changes
+constexpr std::uint32_t kQuoteCacheVersion = 1;
+constexpr std::array<char, 8> kQuoteCacheMagic{'S', 'I', 'M', 'Q', 'U', 'O', 'T', 'E'};
+
+/**
+ * @brief Fixed-size header at the start of every cache file.
+ * @details Padded to 64 bytes so the quotes that follow keep their natural alignment.
+ */
+struct alignas(64) QuoteCacheHeader {
+    std::array<char, 8> magic{kQuoteCacheMagic};
+    std::uint32_t version{kQuoteCacheVersion};
+    std::uint32_t reserved{0};
+    QuoteCacheKey key{};
+    std::uint64_t numberOfQuotes{0};
+};
+
+static_assert(sizeof(QuoteCacheHeader) == 64);
+
+// FNV-1a, stable across runs and standard library implementations
+std::uint64_t stableHash(std::span<const std::byte> bytes,
+    std::uint64_t hash = 14695981039346656037ULL) {
+    for (std::byte value : bytes) {
+        hash ^= static_cast<std::uint64_t>(value);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::uint64_t stableHash(const std::string& text) {
+    return stableHash(std::as_bytes(std::span(text.data(), text.size())));
+}
+
+bool keysMatch(const QuoteCacheKey& a, const QuoteCacheKey& b) {
+    return a.sourcePathHash == b.sourcePathHash && a.sourceModifiedTime == b.sourceModifiedTime &&
+        a.sourceSize == b.sourceSize && a.symbolFilterHash == b.symbolFilterHash &&
+        a.depth == b.depth && a.quoteSize == b.quoteSize;
+}
+
+std::filesystem::path cacheDirectory(const MarketDataParams& params) {
+    if (!params.quoteCacheDirectory.empty()) {
+        return params.quoteCacheDirectory;
+    }
+    return std::filesystem::temp_directory_path() / "simulation_engine_quote_cache";
+}
+
+}  // namespace
+
+template <std::size_t depth>
+bool makeQuoteCacheKey(const std::string& sourcePath,
+    const MarketDataParams& params,
+    QuoteCacheKey& key) {
+    std::error_code error;
+    const std::filesystem::path canonicalPath = std::filesystem::canonical(sourcePath, error);
+    if (error) return false;
+
+    const auto modifiedTime = std::filesystem::last_write_time(canonicalPath, error);
+    if (error) return false;
+
+    const auto sourceSize = std::filesystem::file_size(canonicalPath, error);
+    if (error) return false;
+
+    key.sourcePathHash = stableHash(canonicalPath.string());
+    key.sourceModifiedTime = static_cast<std::int64_t>(modifiedTime.time_since_epoch().count());
+    key.sourceSize = static_cast<std::uint64_t>(sourceSize);
+    key.symbolFilterHash = stableHash(std::as_bytes(std::span(params.symbolIds)));
+    key.depth = static_cast<std::uint32_t>(depth);
+    key.quoteSize = static_cast<std::uint32_t>(sizeof(Quote<depth>));
+    return true;
+}
+
+template <std::size_t depth>
+std::string quoteCachePath(const std::string& sourcePath, const MarketDataParams& params) {
+    std::error_code error;
+    std::filesystem::path canonicalPath = std::filesystem::canonical(sourcePath, error);
+    if (error) canonicalPath = sourcePath;
+
+    std::ostringstream fileName;
+    fileName << canonicalPath.stem().string() << '_' << std::hex
+             << stableHash(canonicalPath.string()) << std::dec << "_d" << depth;
+    if (!params.symbolIds.empty()) {
+        fileName << "_s" << std::hex
+                 << stableHash(std::as_bytes(std::span(params.symbolIds)));
+    }
+    fileName << ".qcache";
+
+    return (cacheDirectory(params) / fileName.str()).string();
+}
+
+template <std::size_t depth>
+bool writeQuoteCache(const std::string& cachePath,
+    const QuoteCacheKey& key,
+    std::span<const Quote<depth>> quotes) {
+    static_assert(std::is_trivially_copyable_v<Quote<depth>>);
+
+    std::error_code error;
+    const std::filesystem::path finalPath{cachePath};
+    std::filesystem::create_directories(finalPath.parent_path(), error);
+    if (error) return false;
+
+    // Unique per process and thread so concurrent writers never share a temporary file
+    const std::filesystem::path temporaryPath = finalPath.string() + ".tmp" +
+        std::to_string(::getpid()) + "." +
+        std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        QuoteCacheHeader header;
+        header.key = key;
+        header.numberOfQuotes = quotes.size();
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(quotes.data()),
+            static_cast<std::streamsize>(quotes.size_bytes()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, finalPath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+template <std::size_t depth>
+MappedQuoteFile<depth>::~MappedQuoteFile() {
+    close();
+}
+
+template <std::size_t depth>
+MappedQuoteFile<depth>::MappedQuoteFile(MappedQuoteFile&& other) noexcept
+    : address_(std::exchange(other.address_, nullptr)),
+      length_(std::exchange(other.length_, 0)),
+      quotes_(std::exchange(other.quotes_, {})) {}
+
+template <std::size_t depth>
+MappedQuoteFile<depth>& MappedQuoteFile<depth>::operator=(MappedQuoteFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        address_ = std::exchange(other.address_, nullptr);
+        length_ = std::exchange(other.length_, 0);
+        quotes_ = std::exchange(other.quotes_, {});
+    }
+    return *this;
+}
+
+template <std::size_t depth>
+bool MappedQuoteFile<depth>::open(const std::string& cachePath, const QuoteCacheKey& key) {
+    close();
+
+    const int fileDescriptor = ::open(cachePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0) return false;
+
+    struct stat fileStatus {};
+    if (::fstat(fileDescriptor, &fileStatus) != 0 ||
+        static_cast<std::size_t>(fileStatus.st_size) < sizeof(QuoteCacheHeader)) {
+        ::close(fileDescriptor);
+        return false;
+    }
+
+    const std::size_t length = static_cast<std::size_t>(fileStatus.st_size);
+    void* address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    // The mapping keeps the file alive on its own
+    ::close(fileDescriptor);
+    if (address == MAP_FAILED) return false;
+
+    const auto* header = static_cast<const QuoteCacheHeader*>(address);
+    const std::size_t expectedLength =
+        sizeof(QuoteCacheHeader) + header->numberOfQuotes * sizeof(Quote<depth>);
+    if (header->magic != kQuoteCacheMagic || header->version != kQuoteCacheVersion ||
+        !keysMatch(header->key, key) || length != expectedLength) {
+        ::munmap(address, length);
+        return false;
+    }
+
+    // Quotes are consumed front to back, so ask the kernel to read ahead aggressively
+    ::madvise(address, length, MADV_SEQUENTIAL);
+
+    address_ = address;
+    length_ = length;
+    quotes_ = std::span<const Quote<depth>>(
+        reinterpret_cast<const Quote<depth>*>(static_cast<const std::byte*>(address) +
+            sizeof(QuoteCacheHeader)),
+        header->numberOfQuotes);
+    return true;
+}
+
+template <std::size_t depth>
+void MappedQuoteFile<depth>::close() {
+    if (address_ != nullptr) {
+        ::munmap(address_, length_);
+    }
+    address_ = nullptr;
+    length_ = 0;
+    quotes_ = {};
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool MarketDataQuoteCache<depth, numberOfSymbols>::loadData(
+    const std::string& marketDataFilePath) {
+    mappedFile_.close();
+    this->quotes_.clear();
+
+    QuoteCacheKey key;
+    if (!makeQuoteCacheKey<depth>(marketDataFilePath, this->params_, key)) return false;
+
+    const std::string cachePath = quoteCachePath<depth>(marketDataFilePath, this->params_);
+    if (mappedFile_.open(cachePath, key)) return true;
+
+    // First load of this file: decode it, persist the filtered quotes, then serve the mapping.
+    // Only a decode that reached the end of the file is persisted; a partial one would be served
+    // as the whole file by every later run.
+    std::vector<Quote<depth>> quotes;
+    if (!readParquetQuotes<depth>(marketDataFilePath, this->params_, quotes)) return false;
+
+    if (writeQuoteCache<depth>(cachePath, key, quotes) && mappedFile_.open(cachePath, key)) {
+        return true;
+    }
+    this->quotes_.assign(std::move(quotes));
+    return true;
+}
+
+template <std::size_t depth, std::uint16_t numberOfSymbols>
+bool MarketDataQuoteCache<depth, numberOfSymbols>::loadData() {
+    if (!this->multipleFiles_) {
+        return loadData(this->marketDataFilePath_);
+    }
+
+    if (this->currentFileIndex >= this->marketDataFilePaths_.size()) {
+        return false;
+    }
+    return loadData(this->marketDataFilePaths_[this->currentFileIndex]);
+}
+
+// Explicit template instantiations
+template bool makeQuoteCacheKey<10>(const std::string&, const MarketDataParams&, QuoteCacheKey&);
+template std::string quoteCachePath<10>(const std::string&, const MarketDataParams&);
+template bool writeQuoteCache<10>(const std::string&,
+    const QuoteCacheKey&,
+    std::span<const Quote<10>>);
+template class MappedQuoteFile<10>;
+template class MarketDataQuoteCache<10, 1>;
+template class MarketDataQuoteCache<10, 4>;
+
+}  // namespace sim
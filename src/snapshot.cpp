@@ -0,0 +1,68 @@
+// snapshot.cpp
+module;
+#include <unistd.h>
+
+module simulation_engine;
+
+import std;
+
+namespace sim {
+
+bool saveSnapshot(const std::string& path, const EngineSnapshot& snapshot) {
+    const std::filesystem::path finalPath{path};
+    std::error_code error;
+    if (finalPath.has_parent_path()) {
+        std::filesystem::create_directories(finalPath.parent_path(), error);
+        if (error) return false;
+    }
+
+    // Unique per process and thread so concurrent runs never share a temporary file
+    const std::filesystem::path temporaryPath = finalPath.string() + ".tmp" +
+        std::to_string(::getpid()) + "." +
+        std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        const std::span<const std::byte> bytes = snapshot.bytes();
+        out.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, finalPath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool loadSnapshot(const std::string& path, EngineSnapshot& snapshot) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+
+    const std::streamsize size = in.tellg();
+    if (size < static_cast<std::streamsize>(sizeof(SnapshotHeader))) return false;
+
+    std::vector<std::byte> bytes(static_cast<std::size_t>(size));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(bytes.data()), size);
+    if (!in) return false;
+
+    SnapshotHeader header;
+    SnapshotReader reader(bytes);
+    if (!reader.read(header) || header.magic != kSnapshotMagic ||
+        header.version != kSnapshotVersion) {
+        return false;
+    }
+
+    snapshot = EngineSnapshot(std::move(bytes));
+    return true;
+}
+
+}  // namespace sim
@@ -31,27 +31,38 @@ void Statistics<depth, Distribution>::outputSummary(std::ostream& outFile,
 }
 
 template <std::size_t depth, typename Distribution>
-void Statistics<depth, Distribution>::outputMinimal(std::ostream& out) const {
-    outputHeader(out, "Simulation Results");
-
-    Ticks finalMarketValue = runningStatistics.previousPortfolioValue;
+RunMetrics Statistics<depth, Distribution>::metrics() const {
+    RunMetrics metrics;
+    metrics.finalValue = runningStatistics.previousPortfolioValue;
 
     // Calculate total return from current equity
-    double totalReturn = 0.0;
     if (startingMarketValue_.value() != 0) {
-        totalReturn =
-            (static_cast<double>(finalMarketValue.value()) - startingMarketValue_.value()) / startingMarketValue_.value();
+        metrics.totalReturn =
+            (static_cast<double>(metrics.finalValue.value()) - startingMarketValue_.value()) /
+            startingMarketValue_.value();
     }
+    metrics.maxDrawdown = calculateMaxDrawdownPercent();
+    metrics.volatility = calculateVolatility();
+    metrics.sharpeRatio = calculateAnnualizedSharpeRatio();
+    metrics.fills = fillsHistory.size();
+    return metrics;
+}
+
+template <std::size_t depth, typename Distribution>
+void Statistics<depth, Distribution>::outputMinimal(std::ostream& out) const {
+    outputHeader(out, "Simulation Results");
+
+    const RunMetrics runMetrics = metrics();
 
     out << "Starting Equity: " << formatTicksAsDollars(startingMarketValue_) << std::endl;
-    out << "Final Portfolio Value: " << formatTicksAsDollars(finalMarketValue) << std::endl;
-    out << "Total Return: " << formatPercentage(totalReturn) << std::endl;
-    out << "Max Drawdown: " << formatPercentage(this->calculateMaxDrawdownPercent()) << std::endl;
-    out << "Volatility: " << formatPercentage(calculateVolatility()) << std::endl;
-    out << "Sharpe Ratio: " << std::fixed << std::setprecision(4)
-        << calculateAnnualizedSharpeRatio() << std::endl;
+    out << "Final Portfolio Value: " << formatTicksAsDollars(runMetrics.finalValue) << std::endl;
+    out << "Total Return: " << formatPercentage(runMetrics.totalReturn) << std::endl;
+    out << "Max Drawdown: " << formatPercentage(runMetrics.maxDrawdown) << std::endl;
+    out << "Volatility: " << formatPercentage(runMetrics.volatility) << std::endl;
+    out << "Sharpe Ratio: " << std::fixed << std::setprecision(4) << runMetrics.sharpeRatio
+        << std::endl;
     out << "Interest Owed: " << formatTicksAsDollars(totalInterestOwed_) << std::endl;
-    out << "Fills: " << fillsHistory.size() << std::endl;
+    out << "Fills: " << runMetrics.fills << std::endl;
 }
 
 template <std::size_t depth, typename Distribution>
@@ -70,16 +81,17 @@ void Statistics<depth, Distribution>::outputStandard(std::ostream& out) const {
 
 template <std::size_t depth, typename Distribution>
 void Statistics<depth, Distribution>::outputDetailed(std::ostream& out) const {
-    // TODO: Detailed mode will show various stats about multiple simulation trials
-    // when rerunning with different competition/liquidity hyperparameters
-    // For now, detailed does nothing
-
-    // Commented out for future implementation:
-    // - Multiple trial statistics
-    // - Competition/liquidity hyperparameter analysis
-    // - Performance comparison across different parameter sets
-    // outputOrdersPlaced(out);
-    // outputFillsReceived(out);
+    outputStandard(out);
+
+    // A single run only knows its own fill-rate stream; the spread over many streams is reported
+    // by TrialStatistics when the run is repeated with ParameterSweep::runFillModelTrials
+    outputHeader(out, "Fill Model");
+    if (simulationParams_.fillRateSeed) {
+        out << "Fill Rate Seed: " << *simulationParams_.fillRateSeed << std::endl;
+        out << "Trial: " << simulationParams_.trialIndex << std::endl;
+    } else {
+        out << "Fill Rate Seed: random (not reproducible)" << std::endl;
+    }
 }
 
 template <std::size_t depth, typename Distribution>
@@ -241,6 +253,21 @@ void Statistics<depth, Distribution>::updateInterestOwed(Ticks interestOwed) {
     totalInterestOwed_ = interestOwed;
 }
 
+template <std::size_t depth, typename Distribution>
+void Statistics<depth, Distribution>::save(SnapshotWriter& out) const {
+    out.write(startingMarketValue_);
+    out.write(totalInterestOwed_);
+    out.write(runningStatistics);
+    out.write(orderHistory);
+    out.write(fillsHistory);
+}
+
+template <std::size_t depth, typename Distribution>
+bool Statistics<depth, Distribution>::load(SnapshotReader& in) {
+    return in.read(startingMarketValue_) && in.read(totalInterestOwed_) &&
+        in.read(runningStatistics) && in.read(orderHistory) && in.read(fillsHistory);
+}
+
 template <std::size_t depth, typename Distribution>
 double Statistics<depth, Distribution>::calculateVolatility() const {
     return runningStatistics.calculateAnnualizedVolatility(sampleRateSeconds_);
@@ -261,5 +288,119 @@ double Statistics<depth, Distribution>::calculateMaxDrawdownPercent() const {
 
 // Explicit template instantiations
 template class Statistics<10, ConstantDistribution>;
+template class Statistics<10, BetaDistribution>;
+template class Statistics<10, AnyDistribution>;
+
+// Monte Carlo trial statistics
+TrialStatistics::TrialStatistics(std::uint64_t seed) : seed_{seed} {}
+
+void TrialStatistics::add(std::uint64_t trialIndex, const RunMetrics& metrics) {
+    trials_.push_back({trialIndex, metrics});
+}
+
+void TrialStatistics::addFailure(std::uint64_t trialIndex, const std::string& error) {
+    failures_.push_back({trialIndex, error});
+}
+
+const RunMetrics* TrialStatistics::find(std::uint64_t trialIndex) const {
+    for (const Trial& trial : trials_) {
+        if (trial.index == trialIndex) return &trial.metrics;
+    }
+    return nullptr;
+}
+
+TrialStatistics::Summary TrialStatistics::summarize(double (*metric)(const RunMetrics&)) const {
+    Summary summary;
+    if (trials_.empty()) return summary;
+
+    std::vector<double> values;
+    values.reserve(trials_.size());
+    for (const Trial& trial : trials_) values.push_back(metric(trial.metrics));
+    std::ranges::sort(values);
+
+    double sum = 0.0;
+    for (double value : values) sum += value;
+    summary.mean = sum / values.size();
+
+    double sumOfSquaredDifferences = 0.0;
+    for (double value : values) {
+        sumOfSquaredDifferences += (value - summary.mean) * (value - summary.mean);
+    }
+    summary.standardDeviation =
+        (values.size() > 1) ? std::sqrt(sumOfSquaredDifferences / (values.size() - 1)) : 0.0;
+
+    // Nearest-rank percentiles, so every reported value is one a trial actually produced
+    auto percentile = [&](double p) {
+        const std::size_t rank = static_cast<std::size_t>(std::ceil(p * values.size()));
+        return values[std::clamp<std::size_t>(rank, 1, values.size()) - 1];
+    };
+    summary.minimum = values.front();
+    summary.percentile5 = percentile(0.05);
+    summary.median = percentile(0.50);
+    summary.percentile95 = percentile(0.95);
+    summary.maximum = values.back();
+    return summary;
+}
+
+void TrialStatistics::outputSummaryRow(std::ostream& out,
+    const std::string& name,
+    const Summary& summary,
+    double scale,
+    int precision) const {
+    out << std::left << std::setw(16) << name << std::right << std::fixed
+        << std::setprecision(precision);
+    for (double value : {summary.mean, summary.standardDeviation, summary.minimum,
+             summary.percentile5, summary.median, summary.percentile95, summary.maximum}) {
+        out << std::setw(14) << value * scale;
+    }
+    out << std::endl;
+}
+
+void TrialStatistics::outputDetailed(std::ostream& out) const {
+    const std::string title = "Fill Model Trials";
+    out << "\n" << title << "\n" << std::string(title.length(), '-') << "\n";
+    out << "Seed: " << seed_ << std::endl;
+    out << "Trials: " << trials_.size() << " completed, " << failures_.size() << " failed"
+        << std::endl;
+
+    if (!trials_.empty()) {
+        out << std::endl;
+        out << std::left << std::setw(16) << "Metric" << std::right << std::setw(14) << "Mean"
+            << std::setw(14) << "Std Dev" << std::setw(14) << "Min" << std::setw(14) << "P5"
+            << std::setw(14) << "Median" << std::setw(14) << "P95" << std::setw(14) << "Max"
+            << std::endl;
+        out << std::string(114, '-') << std::endl;
+
+        // Dollars and percentages, as in the single-run summary
+        outputSummaryRow(out, "Final Value ($)",
+            summarize([](const RunMetrics& m) { return static_cast<double>(m.finalValue.value()); }),
+            1e-6, 2);
+        outputSummaryRow(out, "Return (%)",
+            summarize([](const RunMetrics& m) { return m.totalReturn; }), 100.0, 4);
+        outputSummaryRow(out, "Max Drawdown (%)",
+            summarize([](const RunMetrics& m) { return m.maxDrawdown; }), 100.0, 4);
+        outputSummaryRow(out, "Volatility (%)",
+            summarize([](const RunMetrics& m) { return m.volatility; }), 100.0, 4);
+        outputSummaryRow(out, "Sharpe Ratio",
+            summarize([](const RunMetrics& m) { return m.sharpeRatio; }), 1.0, 4);
+        outputSummaryRow(out, "Fills",
+            summarize([](const RunMetrics& m) { return static_cast<double>(m.fills); }), 1.0, 1);
+
+        const auto byFinalValue = [](const Trial& a, const Trial& b) {
+            return a.metrics.finalValue < b.metrics.finalValue;
+        };
+        const Trial& worst = *std::ranges::min_element(trials_, byFinalValue);
+        const Trial& best = *std::ranges::max_element(trials_, byFinalValue);
+        out << std::endl;
+        out << "Best Trial: " << best.index << " (final value $" << std::setprecision(2)
+            << best.metrics.finalValue.value() / 1'000'000.0 << ")" << std::endl;
+        out << "Worst Trial: " << worst.index << " (final value $" << std::setprecision(2)
+            << worst.metrics.finalValue.value() / 1'000'000.0 << ")" << std::endl;
+    }
+
+    for (const Failure& failure : failures_) {
+        out << "Trial " << failure.index << " failed: " << failure.error << std::endl;
+    }
+}
 
 }  // namespace sim
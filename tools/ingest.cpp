@@ -0,0 +1,94 @@
+import std;
+import simulation_engine;
+
+namespace sim {
+
+void printUsage(std::ostream& out) {
+    out << "Usage: ingest --output <directory> --symbols <A,B,...> [options] <raw day files...>\n"
+        << "\n"
+        << "Options:\n"
+        << "  --scale <n>         Price scale factor (default 10000)\n"
+        << "  --threads <n>       Days ingested concurrently, 0 for every core (default 1)\n"
+        << "  --prefix <text>     Output file name prefix (default indexed_)\n"
+        << "  --quote-cache       Also write the memory-mapped quote cache of every day\n"
+        << "  --cache-dir <path>  Quote cache directory (default system temporary directory)\n"
+        << "  --overwrite         Re-ingest days whose output already exists\n";
+}
+
+std::vector<std::string> splitSymbols(const std::string& list) {
+    std::vector<std::string> symbols;
+    for (auto symbol : std::views::split(list, ',')) {
+        if (!symbol.empty()) symbols.emplace_back(symbol.begin(), symbol.end());
+    }
+    return symbols;
+}
+
+// Whole-string parse, so "12abc", "-1" for an unsigned value or an overflow are all rejected
+template <typename Integer>
+bool parseInteger(const std::string& text, Integer& value) {
+    const char* last = text.data() + text.size();
+    const auto [end, error] = std::from_chars(text.data(), last, value);
+    return error == std::errc{} && end == last && !text.empty();
+}
+
+}  // namespace sim
+
+int main(int argc, char** argv) {
+    using namespace sim;
+
+    IngestParams params;
+    std::vector<std::string> inputPaths;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        const bool hasValue = (i + 1) < argc;
+
+        if (argument == "--output" && hasValue) {
+            params.outputDirectory = argv[++i];
+        } else if (argument == "--symbols" && hasValue) {
+            params.symbols = splitSymbols(argv[++i]);
+        } else if (argument == "--scale" && hasValue) {
+            if (!parseInteger(argv[++i], params.priceScale) || params.priceScale <= 0) {
+                std::cerr << "--scale expects a positive integer, got " << argv[i] << "\n\n";
+                printUsage(std::cerr);
+                return 1;
+            }
+        } else if (argument == "--threads" && hasValue) {
+            if (!parseInteger(argv[++i], params.threads)) {
+                std::cerr << "--threads expects a non-negative integer, got " << argv[i]
+                          << "\n\n";
+                printUsage(std::cerr);
+                return 1;
+            }
+        } else if (argument == "--prefix" && hasValue) {
+            params.outputPrefix = argv[++i];
+        } else if (argument == "--quote-cache") {
+            params.format = IngestFormat::ParquetWithQuoteCache;
+        } else if (argument == "--cache-dir" && hasValue) {
+            params.marketData.quoteCacheDirectory = argv[++i];
+        } else if (argument == "--overwrite") {
+            params.overwrite = true;
+        } else if (argument == "--help" || argument.starts_with("--")) {
+            printUsage(argument == "--help" ? std::cout : std::cerr);
+            return argument == "--help" ? 0 : 1;
+        } else {
+            inputPaths.push_back(argument);
+        }
+    }
+
+    if (params.outputDirectory.empty() || params.symbols.empty() || inputPaths.empty()) {
+        printUsage(std::cerr);
+        return 1;
+    }
+
+    // Days are written in name order, which for YYYY-MM-DD files is date order
+    std::ranges::sort(inputPaths);
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<IngestDayReport> reports = ingestDays(inputPaths, params);
+    outputIngestReport(reports, std::chrono::steady_clock::now() - start, std::cout);
+
+    const bool allSucceeded = std::ranges::all_of(reports,
+        [](const IngestDayReport& report) { return report.succeeded; });
+    return allSucceeded ? 0 : 1;
+}